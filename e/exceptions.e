@@ -16,8 +16,8 @@
 extern int processCount;
 extern int softBlockCount;
 extern pcb_PTR currentProcess;
-extern pcb_PTR readyQueue;
-extern cpu_t startTOD;
+extern pcb_PTR readyQueue[READYQUEUES];
+extern tod_t startTOD;
 extern int semaphoreArray[MAXSEMA]; 
 
 extern void progTrpHandler();
@@ -25,7 +25,15 @@ extern void tlbHandler();
 extern void sysCallHandler();
 extern void passUpOrDie(int type);
 extern void sysFiveHandle(int type);
-extern void headBackHome();
+extern int setPriority(int prio, int target);
+extern int setTickets(int tickets, int target);
+extern int getShare(int target, int *report);
+extern int setRealTime(cpu_t period, cpu_t budget, int target);
+extern void getTimes(int *report);
+extern void getLoad(loadinfo_t *report);
+extern int getLatency(int target, unsigned int *report, int reset);
+extern void saveState();
+extern void headBackHome(state_t *state);
 extern void nukeItTilItPukes(pcb_PTR parent);
 
 /***************************************************************/
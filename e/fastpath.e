@@ -0,0 +1,20 @@
+#ifndef FASTPATH
+#define FASTPATH
+
+/************************ FASTPATH.E ****************************
+*
+* The externals declaration file for the Syscall Fast Path
+* Module for JAEOS.
+*
+* Written by Jacob Wagner
+* Last Modified: 11-1-16
+*/
+
+#include "../h/types.h"
+#include "../h/const.h"
+
+extern void sysCallEntry();
+
+/***************************************************************/
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef HPT
+#define HPT
+
+/********************** HPT.E *******************************
+ *
+ * The externals declaration file for the Hashed Page Table
+ * Module for JAEOS.
+ *
+ * Written by Jacob Wagner
+ * Last Modified: 11-1-16
+ */
+
+#include "../h/types.h"
+#include "../h/const.h"
+
+extern vpte_t *hptLookup(int asid, unsigned int pageNo);
+extern vpte_t *hptInsert(int asid, unsigned int pageNo);
+extern void hptRemoveProc(int asid);
+extern void initHPT();
+
+/***************************************************************/
+
+#endif
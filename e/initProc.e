@@ -25,7 +25,6 @@ Tproc_t uProcs[MAXUSERPROC];
 extern void test();
 extern void uProcInit();
 extern void enableInterrupts(int onOff);
-extern void copyPage(int *source, int *target);
 extern void delayDaemon();
 
 extern void debugF();
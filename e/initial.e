@@ -16,12 +16,11 @@
 extern int processCount;
 extern int softBlockCount;
 extern pcb_PTR currentProcess;
-extern pcb_PTR readyQueue;
+extern pcb_PTR readyQueue[READYQUEUES];
 extern int waitFlag;
-extern cpu_t startTOD;
+extern tod_t startTOD;
 extern int semaphoreArray[MAXSEMA];
-extern int devStatus[MAXSEMA];
-extern cpu_t timeLeft; 
+extern tod_t clockDeadline;
 extern int intTimerFlag;
 
 extern void test();
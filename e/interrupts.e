@@ -11,11 +11,22 @@
 */
 
 #include "../h/types.h"
+#include "../h/const.h"
 
 extern int waitFlag;
-extern cpu_t startTOD;
+extern tod_t startTOD;
+extern tod_t lastTick;
+extern unsigned int tickPeriods[JITTERBUCKETS];
+extern unsigned int skippedTicks;
+extern unsigned int ackCount[DEVICECNT];
+extern tod_t ackTotal[DEVICECNT];
+extern tod_t ackMax[DEVICECNT];
+extern unsigned int statusOverruns;
 
 extern void interruptHandler();
+extern void initInterrupts();
+extern unsigned int popStatus(int semDev);
+extern void clockTick(tod_t now);
 extern int getDeviceNumber(int lineNumber);
 extern void handleTerminal(int devNumber);
 extern void returnFromInterrupt();
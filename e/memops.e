@@ -0,0 +1,23 @@
+#ifndef MEMOPS
+#define MEMOPS
+
+/************************* MEMOPS.E *****************************
+*
+* The externals declaration file for the Block Memory Operations
+* Module for JAEOS.
+*
+* Written by Jacob Wagner
+* Last Modified: 11-1-16
+*/
+
+#include "../h/types.h"
+#include "../h/const.h"
+
+extern void moveState(state_t *source, state_t *target);
+extern void copyPage(int *source, int *target);
+extern void zeroPage(int *target);
+extern int comparePage(int *first, int *second);
+
+/***************************************************************/
+
+#endif
@@ -24,6 +24,7 @@ extern pcb_PTR outChild (pcb_PTR p);
 extern pcb_PTR mkEmptyProcQ ();
 extern int emptyProcQ (pcb_PTR tp);
 extern void insertProcQ (pcb_PTR *tp, pcb_PTR p);
+extern void insertAfterProcQ (pcb_PTR *tp, pcb_PTR q, pcb_PTR p);
 extern pcb_PTR removeProcQ (pcb_PTR *tp);
 extern pcb_PTR outProcQ (pcb_PTR *tp, pcb_PTR p);
 extern pcb_PTR headProcQ (pcb_PTR tp);
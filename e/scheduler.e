@@ -11,18 +11,53 @@
 */
 
 #include "../h/types.h"
-
+#include "../h/const.h"
 
 extern int processCount;
 extern int softBlockCount;
 extern pcb_PTR currentProcess;
-extern pcb_PTR readyQueue;
+extern pcb_PTR readyQueue[READYQUEUES];
+extern int boostEpoch;
+extern int deadlineMisses;
+extern int budgetOverruns;
+extern tod_t intTime;
+extern tod_t idleTime;
+extern tod_t kernTime;
+extern loadinfo_t loadInfo;
+extern unsigned int latencyHist[LATBUCKETS];
 extern int waitFlag;
-extern cpu_t startTOD;
+extern tod_t startTOD;
 
 extern void getNewJob();
 extern void processJob(pcb_PTR newJob);
-extern void moveState(state_t *source, state_t *target);
+extern void recordLatency(pcb_PTR p, tod_t delay);
+extern void initReady();
+extern void makeReady(pcb_PTR p);
+extern pcb_PTR removeReady();
+extern pcb_PTR outReady(pcb_PTR p);
+extern void demote(pcb_PTR p);
+extern void promote(pcb_PTR p);
+extern void agePriorities();
+extern tod_t quantumOf(pcb_PTR p);
+extern int lowestBit(unsigned int map);
+extern void chargeTime(pcb_PTR p, tod_t elapsed);
+extern void initAccounts();
+extern void initLoad();
+extern void sampleLoad(tod_t now, int ticks);
+extern void switchAccount(int next);
+extern void joinSiblings(pcb_PTR p);
+extern int admitRealTime(pcb_PTR p, cpu_t period, cpu_t budget);
+extern void leaveRealTime(pcb_PTR p);
+extern void edfRelease();
+extern tod_t edfNextRelease();
+extern void quantumExpired(pcb_PTR p);
+extern int shouldPreempt();
+extern void preempt();
+extern void handOff(pcb_PTR p);
+extern void wakeReady(pcb_PTR p);
+extern void setNextTimer(pcb_PTR job);
+extern void rearmTimer();
+extern cpu_t todToMicros(tod_t ticks);
 
 /***************************************************************/
 
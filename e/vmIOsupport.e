@@ -13,11 +13,30 @@
 #include "../h/types.h"
 #include "../h/const.h"
 
+extern int pinnedFrames;
+
 extern void vmPrgmHandler();
 extern void vmMemHandler();
 extern void vmSysHandler();
 
 extern int chooseFrame();
+extern memaddr frameAddress(int frameNumber);
+extern void evictFrame(int frameNumber, int writeBack);
+extern void pageIn(vpte_t *vpte, int procID, int *fill);
+extern void readAhead(vpte_t *vpte, int procID);
+extern int adviseRange(memaddr addr, int len, int advice, int procID);
+extern pteEntry_t *findSlot(pte_t *pageTable, unsigned int entryHI);
+extern int pageMapped(int segNo, int pageNo, int procID);
+extern int allocBlock(int procID);
+extern int stackOverflow(int procID, int pageNo);
+extern int moveBreak(int increment, int procID);
+extern vpte_t *newPage(int procID, int pageNo);
+extern int setPager(memaddr addr, int len, int pagerID, int procID);
+extern int pagerOwns(int procID, int pageNo);
+extern int *forwardFault(int procID, int pageNo);
+extern int pagerWait(int *request, int procID);
+extern int pagerSupply(int requestID, int *buffer, int procID);
+extern void pagerDeath(int procID);
 extern void readWriteBacking(int cylinder, int sector, int head, int readWriteComm, memaddr address);
 extern void virtualDeath(int procID);
 extern void writeTerminal(char* virtAddr, int len, int procID);
@@ -15,6 +15,7 @@
 /* hardware & software constants */
 #define PAGESIZE		4096	/* page size in bytes */
 #define WORDLEN			4		/* word size in bytes */
+#define BURSTWORDS		8		/* words moved by one block load or store */
 #define PTEMAGICNO		0x2A
 
 #define SWAPSIZE		(2 * MAXUSERPROC)
@@ -26,6 +27,10 @@
 #define TAPEBUFFTOP		(OSCODETOP + (DEVPERINT * PAGESIZE))
 #define DISKBUFFTOP		(TAPEBUFFTOP + (DEVPERINT * PAGESIZE))
 #define EXECTOP			(DISKBUFFTOP + ((MAXUSERPROC * 2) * PAGESIZE))
+#define TAPEBUFF(ID)	(OSCODETOP + (((ID) - 1) * PAGESIZE))
+#define DISKBUFF(N)		(TAPEBUFFTOP + ((N) * PAGESIZE))
+#define PAGERBUFF(ID)	TAPEBUFF(ID)	/* free once the image is loaded */
+#define KSEGOSTOP		(ROMPAGESTART + (KSEGOSPTESIZE * PAGESIZE))
 
 /* addresses of handler new/old areas */
 #define INTERRUPTOLDADDR	0x7000
@@ -40,6 +45,7 @@
 /* bus register addresses */
 #define INTBITMAPADDR		0x6FE0
 #define DEVREGAREAADDR		0x2D0
+#define TODHIADDR			0x2DC
 #define TODLOADDR			0x2E0
 #define INTERVALTMR			0x2E4
 #define TIMESCALEADDR		0x2E8
@@ -56,6 +62,31 @@
 #define KUSEGPTESIZE	32
 #define KSEGOSPTESIZE	64
 #define KUSEG3			3
+#define KUSEG2			2
+#define SEGSHIFT		30
+#define PAGENOMASK		0x3FFFF000
+#define EMPTYSLOT		0
+
+/* user stack information (pages of kUseg2) */
+#define STACKTOPPAGE	0x3FFFF
+#define STACKMAXPAGES	16
+#define STACKGUARDPAGES	16
+
+/* hashed page table information */
+#define HPTBUCKETS		64
+#define HPTSIZE			(MAXUSERPROC * 64)
+#define VP_ONDISK		0x1
+#define VP_PIN			0x2
+#define VP_SEQUENTIAL	0x4
+#define VP_BEHIND		0x8
+#define READAHEAD		2
+
+/* user-level pager request states */
+#define PAGERIDLE		0
+#define PAGERPENDING	1
+#define PAGERCLAIMED	2
+#define PAGERSUPPLIED	3
+#define PAGERFAILED		4
 
 /* current program status (cpsr) bit patterns */
 #define ALLOFF			0
@@ -93,7 +124,14 @@
 #define LINESIX		0x00000040
 #define LINESEVEN	0x00000080
 
+#define INTLINES	8
+#define LINESHIFT	24		/* the lines pending in the cause register */
+#define LINESETS	256		/* every set of lines in the cause register */
+#define HANDLEDLINES	(LINETWO | LINETHREE | LINEFOUR | LINEFIVE | \
+						LINESIX | LINESEVEN)
+
 #define DEVICEONE	0x00000001
+#define DEVICEMASK	0x000000FF
 
 /* system control bit (cp15) patterns */
 #define VMON			0x1
@@ -126,6 +164,18 @@
 #define WAITFORCLOCK		7
 #define	WAITFORIO			8
 
+/* extended nucleus services, privileged like Syscalls 1-8 */
+#define EXTSYSSTART			32
+#define SETPRIORITY			32
+#define SETTICKETS			33
+#define GETSHARE			34
+#define SETREALTIME			35
+#define HANDOFF				36
+#define GETTIMES			37
+#define GETLOAD				38
+#define GETLATENCY			39
+#define EXTSYSEND			47
+
 #define READTERMINAL		9
 #define WRITETERMINAL		10
 #define VSEMVIRT			11
@@ -136,11 +186,106 @@
 #define WRITEPRINTER		16
 #define GETTOD				17
 #define VMTERMINATE			18
-
-/* time constants */
+#define SBRK				19
+#define MADVISE				20
+#define SETPAGER			21
+#define PAGERWAIT			22
+#define PAGERSUPPLY			23
+
+/* memory advice codes */
+#define MADVNORMAL			0
+#define MADVWILLNEED		1
+#define MADVDONTNEED		2
+#define MADVSEQUENTIAL		3
+#define MADVPIN				4
+
+/* time constants, in microseconds */
 #define QUANTUM			5000
 #define INTERVALTIME	100000
 
+/* the longest interval timer load, in TOD ticks */
+#define TIMERMAX		0x7FFFFFFF
+
+/* pseudo clock tick period histogram, buckets of 1 << JITTERSHIFT
+ * microseconds centered on INTERVALTIME */
+#define JITTERBUCKETS	16
+#define JITTERSHIFT		7
+
+/* multi-level feedback queue information, one level is plain round robin */
+#ifndef MLFQLEVELS
+#define MLFQLEVELS		4
+#endif
+#define BOOSTTICKS		10
+
+/* static priority information, priority 0 is the most important */
+#define NUMPRIO			4
+#define PRIODAEMON		0
+#define DEFAULTPRIO		2
+#define READYQUEUES		(NUMPRIO * MLFQLEVELS)
+#define TARGETSELF		0
+#define TARGETCHILD		1
+#define TARGETSYSTEM	2
+
+/* proportional share information, tickets are split between siblings */
+#define DEFAULTTICKETS	100
+#define MAXTICKETS		10000
+#define STRIDESCALE		100
+#define STRIDESHIFT		16
+#define DEFAULTSTRIDE	((STRIDESCALE << STRIDESHIFT) / DEFAULTTICKETS)
+#define SHARESCALE		1000
+#define SHAREBITS		20
+
+/* the accounts CPU time is charged to, the first two are the current
+ * process's own and the others are kept by the nucleus */
+#define ACCTUSER		0
+#define ACCTSYS			1
+#define ACCTINT			2
+#define ACCTIDLE		3
+#define ACCTKERNEL		4
+#define NUMACCTS		5
+
+/* load average information, in fixed point with LOADSHIFT fraction bits
+ * and decayed every pseudo clock tick over one, five and fifteen minutes,
+ * the decay factors assume an INTERVALTIME of 100 milliseconds */
+#define LOADAVGS		3
+#define LOADSHIFT		16
+#define LOADFIXED1		(1 << LOADSHIFT)
+#define LOADEXP1		65427
+#define LOADEXP5		65514
+#define LOADEXP15		65529
+#define LOADHISTORY		16		/* a power of two */
+
+/* ready to run latency histograms, bucket i holds the delays under
+ * LATBASE << i microseconds and the last one holds the rest */
+#define LATBUCKETS		16
+#define LATBASE			8
+
+/* what happens to a job whose I/O completes once the interrupted job
+ * has used more than WAKETHRESHOLD percent of its quantum: nothing, it
+ * runs next or it takes the CPU right away */
+#define WAKEQUEUE		0
+#define WAKEHEAD		1
+#define WAKEPREEMPT		2
+#ifndef WAKEPOLICY
+#define WAKEPOLICY		WAKEQUEUE
+#endif
+#define WAKETHRESHOLD	50
+
+/* whether syscalls enter through the P and V fast path, and the byte
+ * offsets into a state_t of the registers it uses */
+#ifndef FASTSYSCALL
+#define FASTSYSCALL		1
+#endif
+#define STATEA1			0
+#define STATEA2			4
+#define STATEPC			60
+#define STATECPSR		64
+
+/* earliest deadline first real time class information */
+#define EDFMAXUTIL		900
+#define EDFMINPERIOD	1000
+#define EDFMINSLICE		100
+
 /* entry bit definitions and shifts */
 #define DIRTY			(1 << 10)
 #define VALID			(1 << 9)
@@ -154,6 +299,7 @@
 #define SECTORSHIFT		8
 #define HEADSHIFT		16
 #define SEEKSHIFT		8
+#define CYLSHIFT		16
 #define CHARSHIFT		8
 
 /* specified device and device semaphore numbers */
@@ -183,6 +329,31 @@
 
 #define DEVPERINT	8
 #define DEVINTNUM	5
+#define DEVICECNT	(DEVINTNUM * DEVPERINT)
+#define DEVSEMS		(DEVICECNT + DEVPERINT)	/* terminals have two */
+#define STATUSSLOTS	8		/* a power of two */
+#define NOSTATUS	0xFFFFFFFF	/* a completion whose status was lost */
+
+/* the order the interrupt lines are handled in, one hex digit per line,
+ * most important first, every line from 2 to 7 must be in it */
+#ifndef LINEORDER
+#define LINEORDER		0x234567
+#endif
+#define LINEORDERLEN	6
+#define LINEDIGIT(I)	((LINEORDER >> ((I) * 4)) & 0xF)
+
+/* six digits naming six different lines from 2 to 7 name each of them */
+#if ((LINEORDER >> (LINEORDERLEN * 4)) != 0) || \
+	(((1 << LINEDIGIT(0)) | (1 << LINEDIGIT(1)) | (1 << LINEDIGIT(2)) | \
+	  (1 << LINEDIGIT(3)) | (1 << LINEDIGIT(4)) | (1 << LINEDIGIT(5))) \
+	  != HANDLEDLINES)
+#error "LINEORDER must order each of the interrupt lines 2 to 7 once"
+#endif
+
+/* every region up to the exec stacks must be mapped by kSegOS */
+#if EXECTOP > KSEGOSTOP
+#error "MAXUSERPROC is too large for the pages kSegOS maps"
+#endif
 
 #define DEVREGLEN	4	/* device register field length in bytes & regs per dev */
 #define DEVREGSIZE	16 	/* device register size in bytes */
@@ -225,6 +396,7 @@
 #define TRANSMITCHAR	5
 #define RECEIVECHAR		5
 #define BUSY			3
+#define DEVSTATMASK		0xFF
 
 /* device COMMAND codes */
 #define RESET		0
@@ -233,5 +405,18 @@
 /* useful macros */
 #define STCK(T) ((T) = ((* ((cpu_t *) TODLOADDR)) / (* ((cpu_t *) TIMESCALEADDR))))
 
+/* reads the whole TOD clock in raw ticks, again if the low word wrapped */
+#define TODCK(T) do { \
+		unsigned int todHi; \
+		do { \
+			todHi = * ((unsigned int *) TODHIADDR); \
+			(T) = (((tod_t) todHi) << 32) | \
+					(* ((unsigned int *) TODLOADDR)); \
+		} while (todHi != * ((unsigned int *) TODHIADDR)); \
+	} while (0)
+
+/* converts microseconds to raw TOD ticks without dividing */
+#define USTOTOD(U) (((tod_t) (U)) * (* ((unsigned int *) TIMESCALEADDR)))
+
 
 #endif
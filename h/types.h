@@ -11,6 +11,9 @@
 
 typedef signed int cpu_t;
 
+/* raw 64 bit TOD clock ticks, the nucleus keeps all its time in these */
+typedef signed long long tod_t;
+
 typedef unsigned int memaddr;
 
 typedef struct {
@@ -54,8 +57,25 @@ typedef struct pcb_t {
 	state_PTR oldTlb;
 	state_PTR newTlb;
 	state_t p_s;
-	cpu_t p_time;
+	tod_t p_time;
+	tod_t p_sysTime;
 	int *p_semAdd;
+	int p_level;
+	int p_epoch;
+	int p_prio;
+	int p_tickets;
+	unsigned int p_stride;
+	unsigned int p_pass;
+	tod_t p_treeTime;
+	tod_t p_period;
+	tod_t p_budget;
+	int p_util;
+	tod_t p_used;
+	tod_t p_deadline;
+	int p_throttled;
+	tod_t p_quantumLeft;
+	tod_t p_readyTOD;
+	unsigned int p_latency[LATBUCKETS];
 } pcb_t, *pcb_PTR;
 
 #define	s_a1			s_reg[0]
@@ -81,6 +101,22 @@ typedef struct pcb_t {
 #define s_todHI			s_reg[20]
 #define s_todLO			s_reg[21]
 
+typedef struct loadinfo_t {
+	unsigned int	l_avg[LOADAVGS];
+	int				l_ready;
+	int				l_idle;
+	int				l_procs[LOADHISTORY];
+	int				l_blocked[LOADHISTORY];
+	int				l_next;
+} loadinfo_t;
+
+/* the completions of a device nobody was waiting for yet, oldest first */
+typedef struct statring_t {
+	unsigned int	r_status[STATUSSLOTS];
+	int				r_head;
+	int				r_count;
+} statring_t;
+
 typedef struct pteEntry_t {
 	unsigned int	pte_entryHI;
 	unsigned int	pte_entryLO;
@@ -106,15 +142,36 @@ typedef struct Tproc_t {
 	int			Tp_sem;
 	pte_t		Tp_pte;
 	int			Tp_bckStoreAddr;
+	int			Tp_textPages;
+	int			Tp_stackLimit;
+	memaddr		Tp_heapBase;
+	memaddr		Tp_brk;
+	int			Tp_pagerID;
+	int			Tp_pagerStart;
+	int			Tp_pagerEnd;
+	int			Tp_pagerSem;
+	int			Tp_faultPage;
+	int			Tp_faultState;
+	int			Tp_dead;
 	state_t		Tnew_trap[TRAPTYPES];
 	state_t		Told_trap[TRAPTYPES];
 } Tproc_t, *Tproc_PTR;
 
+typedef struct vpte_t {
+	struct vpte_t	*v_next;
+	int				v_asid;
+	unsigned int	v_pageNo;
+	int				v_block;
+	int				v_frame;
+	int				v_flags;
+} vpte_t;
+
 typedef struct swap_t {
 	int			sw_asid;
 	int			sw_segNo;
 	int			sw_pageNo;
 	pteEntry_t	*sw_pte;
+	vpte_t		*sw_vpte;
 } swap_t;
 
 
@@ -9,11 +9,11 @@
  * points to the end of the queue. Active PCB's are also kept in a queue
  * format with a pointer to the tail of the queue. 
  * 
- * This interface has mutator methods to add objects to a queue, remove 
- * the first object from the queue, remove a specific object from a 
- * queue and also instantiate new queues. It also has accessor methods 
- * that determine if a given queue is empty and retrieve the item at the 
- * head of the queue.
+ * This interface has mutator methods to add objects to a queue or after
+ * a given object in it, remove the first object from the queue, remove 
+ * a specific object from a queue and also instantiate new queues. It 
+ * also has accessor methods that determine if a given queue is empty 
+ * and retrieve the item at the head of the queue.
  * 
  * Each PCB can also be the parent of other PCBs and each child of a 
  * parent is kept in a doubly linked linear queue with a pointer to the 
@@ -45,6 +45,8 @@ HIDDEN pcb_PTR pcbList_h;
  **********************************************************************/
 void freePcb(pcb_PTR p){
 	
+	int i;
+	
 	/*Wash the dishes*/
 		p->p_next = NULL;
 		p->p_prev = NULL;
@@ -53,6 +55,25 @@ void freePcb(pcb_PTR p){
 		p->p_nextSib = NULL;
 		p->p_prevSib = NULL;
 		p->p_time = 0;
+		p->p_sysTime = 0;
+		p->p_level = 0;
+		p->p_epoch = 0;
+		p->p_prio = DEFAULTPRIO;
+		p->p_tickets = DEFAULTTICKETS;
+		p->p_stride = DEFAULTSTRIDE;
+		p->p_pass = 0;
+		p->p_treeTime = 0;
+		p->p_period = 0;
+		p->p_budget = 0;
+		p->p_util = 0;
+		p->p_used = 0;
+		p->p_deadline = 0;
+		p->p_throttled = FALSE;
+		p->p_quantumLeft = 0;
+		p->p_readyTOD = 0;
+		for(i = 0; i < LATBUCKETS; i++){
+			p->p_latency[i] = 0;
+		}
 		
 		p->oldSys = NULL;
 		p->newSys = NULL;
@@ -73,6 +94,8 @@ void freePcb(pcb_PTR p){
  **********************************************************************/
 pcb_PTR allocPcb(){
 	
+	int i;
+	
 	/*Remove the PCB to return from the free list*/
 	pcb_PTR retPcb = removeProcQ(&(pcbList_h));
 
@@ -85,6 +108,25 @@ pcb_PTR allocPcb(){
 		retPcb->p_nextSib = NULL;
 		retPcb->p_prevSib = NULL;
 		retPcb->p_time = 0;
+		retPcb->p_sysTime = 0;
+		retPcb->p_level = 0;
+		retPcb->p_epoch = 0;
+		retPcb->p_prio = DEFAULTPRIO;
+		retPcb->p_tickets = DEFAULTTICKETS;
+		retPcb->p_stride = DEFAULTSTRIDE;
+		retPcb->p_pass = 0;
+		retPcb->p_treeTime = 0;
+		retPcb->p_period = 0;
+		retPcb->p_budget = 0;
+		retPcb->p_util = 0;
+		retPcb->p_used = 0;
+		retPcb->p_deadline = 0;
+		retPcb->p_throttled = FALSE;
+		retPcb->p_quantumLeft = 0;
+		retPcb->p_readyTOD = 0;
+		for(i = 0; i < LATBUCKETS; i++){
+			retPcb->p_latency[i] = 0;
+		}
 		
 		retPcb->oldSys = NULL;
 		retPcb->newSys = NULL;
@@ -166,6 +208,33 @@ void insertProcQ(pcb_PTR *tp, pcb_PTR p){
 }
 
 
+/***********************************************************************
+ *Function that inserts an element into the process queue pointed at
+ *by the given tail pointer just after the given element of the queue,
+ *or at the head of the queue if that element is NULL.
+ *RETURNS: N/A
+ **********************************************************************/
+void insertAfterProcQ(pcb_PTR *tp, pcb_PTR q, pcb_PTR p){
+	
+	/*If the queue is empty or the new element goes at the tail...*/
+	if (emptyProcQ(*tp) || (q == *tp)){
+		insertProcQ(tp, p);
+		return;
+	}
+	
+	/*If the new element goes at the head, it follows the tail*/
+	if (q == NULL){
+		q = *tp;
+	}
+	
+	/*Merge the new element into the list*/
+	p->p_next = q->p_next;
+	q->p_next->p_prev = p;
+	q->p_next = p;
+	p->p_prev = q;
+}
+
+
 /***********************************************************************
  *Function that returns the head of the process queue pointed at by the
  *given tail pointer but does not change the tail pointer.
@@ -0,0 +1,92 @@
+/*********************************ACKBENCH.C****************************
+ *
+ *	Device acknowledgement benchmark for the JAEOS Kernel: phase 2.
+ *
+ *	Keeps every installed disk busy at once with a seeker process each,
+ *	so their interrupts pile up on the same line, and then reports the
+ *	kernel's count of acknowledgements of each disk with the average
+ *	and the longest time it was seen waiting for one. With the devices
+ *	on a line taken in turn, the high numbered disks should wait no
+ *	longer than the low numbered ones.
+ *
+ *      Written by Jake Wagner
+ */
+
+#include "../../h/const.h"
+#include "../../h/types.h"
+
+#include "../../e/interrupts.e"
+#include "../../e/scheduler.e"
+#include "bench.e"
+
+#include "/usr/include/uarm/libuarm.h"
+
+#define QPAGE		1024
+
+#define SEEKS		50
+
+int endSeek = 0;		/* to signal the demise of a seeker */
+
+state_t seekState[DEVPERINT];
+
+/* returns the device registers of the given disk */
+device_t *diskDevice(int disk) {
+
+	devregarea_t *bus = (devregarea_t *) DEVREGAREAADDR;
+	
+	return (device_t *) (bus->devregbase + (disk * DEVREGSIZE));
+}
+
+void seeker(int disk) {
+
+	int i;
+	device_t *dev = diskDevice(disk);
+	
+	for (i = 0; i < SEEKS; i++) {
+		
+		/* the interrupt must not come before the wait */
+		setSTATUS(getSTATUS() | ALLINTDISABLED);
+		dev->d_command = ((i & 1) << SEEKSHIFT) | DISKSEEK;
+		SYSCALL(WAITFORIO, DISKINT, disk, 0);
+		setSTATUS(getSTATUS() & ALLINTENABLED);
+	}
+	
+	SYSCALL(VERHOGEN, (int)&endSeek, 0, 0);
+	SYSCALL(TERMINATEPROCESS, 0, 0, 0);
+}
+
+void test() {
+
+	int i;
+	int disks = 0;
+	
+	benchPrint("ackBench: start\n");
+	
+	for (i = 0; i < DEVPERINT; i++) {
+		if ((diskDevice(i)->d_status & DEVSTATMASK) != UNINSTALLED) {
+			STST(&(seekState[i]));
+			seekState[i].s_sp = seekState[i].s_sp - ((i + 1) * QPAGE);
+			seekState[i].s_pc = (memaddr)seeker;
+			seekState[i].s_a1 = i;
+			SYSCALL(CREATEPROCESS, (int)&(seekState[i]), 0, 0);
+			disks++;
+		}
+	}
+	
+	for (i = 0; i < disks; i++) {
+		SYSCALL(PASSEREN, (int)&endSeek, 0, 0);
+	}
+	
+	for (i = 0; i < DEVPERINT; i++) {
+		if (ackCount[i] > 0) {
+			benchPrintNum("disk: ", i);
+			benchPrintNum("  acks: ", ackCount[i]);
+			benchPrintNum("  average wait (us): ", 
+							todToMicros(ackTotal[i]) / ackCount[i]);
+			benchPrintNum("  longest wait (us): ", todToMicros(ackMax[i]));
+		}
+	}
+	benchPrint("ackBench: done\n");
+	
+	SYSCALL(TERMINATEPROCESS, 0, 0, 0);
+}
@@ -0,0 +1,71 @@
+/* Shared helpers for the phase 2 benchmarks, output goes to Terminal0 */
+
+#include "../../h/const.h"
+#include "../../h/types.h"
+
+#include "bench.e"
+
+#include "/usr/include/uarm/libuarm.h"
+
+typedef unsigned int devregtr;
+
+#define PRINTCHR	2
+#define BYTELEN		8
+#define RECVD		5
+
+#define TERMSTATMASK	0xFF
+
+#define	TERM0ADDR		(0x40 + ((DEVREGSIZE * DEVPERINT) * (DEVINTNUM - 1)))
+
+int benchTermMut = 1;	/* for mutual exclusion on terminal */
+
+/* writes one character to Terminal0 and returns how long it took */
+cpu_t benchPutChar(char c) {
+
+	devregtr *base = (devregtr *) (TERM0ADDR);
+	devregtr status;
+	cpu_t before, after;
+	
+	SYSCALL(PASSEREN, (int)&benchTermMut, 0, 0);
+	
+	STCK(before);
+	*(base + 3) = PRINTCHR | (((devregtr) c) << BYTELEN);
+	status = SYSCALL(WAITFORIO, TERMINT, 0, 0);
+	STCK(after);
+	
+	SYSCALL(VERHOGEN, (int)&benchTermMut, 0, 0);
+	
+	if ((status & TERMSTATMASK) != RECVD) {
+		PANIC();
+	}
+	
+	return (after - before);
+}
+
+void benchPrint(char *msg) {
+
+	char *s = msg;
+	
+	while (*s != EOS) {
+		benchPutChar(*s);
+		s++;
+	}
+}
+
+/* prints the label followed by the number in decimal and a newline */
+void benchPrintNum(char *label, unsigned int num) {
+
+	char buf[12];
+	int i = 11;
+	
+	buf[i] = EOS;
+	do {
+		i--;
+		buf[i] = '0' + (num % 10);
+		num = num / 10;
+	} while (num > 0);
+	
+	benchPrint(label);
+	benchPrint(&(buf[i]));
+	benchPrint("\n");
+}
@@ -0,0 +1,20 @@
+#ifndef BENCH
+#define BENCH
+
+/************************** BENCH.E ******************************
+*
+* The externals declaration file for the shared helpers of the
+* phase 2 benchmarks.
+*
+*  Written by Jake Wagner
+*/
+
+#include "../../h/types.h"
+
+extern void benchPrint(char *msg);
+extern void benchPrintNum(char *label, unsigned int num);
+extern cpu_t benchPutChar(char c);
+
+/***************************************************************/
+
+#endif
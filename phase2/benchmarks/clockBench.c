@@ -0,0 +1,135 @@
+/*********************************CLOCKBENCH.C**************************
+ *
+ *	Pseudo clock benchmark for the JAEOS Kernel: phase 2.
+ *
+ *	A sleeper waits for the pseudo clock over and over while a few hog
+ *	processes keep the CPU busy and a chatter process keeps Terminal0
+ *	interrupting. It reports how far the sleeper's wakeups drifted from
+ *	whole intervals and prints the kernel's histogram of the periods
+ *	between pseudo clock ticks.
+ *
+ *      Written by Jake Wagner
+ */
+
+#include "../../h/const.h"
+#include "../../h/types.h"
+
+#include "../../e/interrupts.e"
+#include "bench.e"
+
+#include "/usr/include/uarm/libuarm.h"
+
+#define QPAGE		1024
+
+#define HOGS		2
+#define TICKS		50
+
+int endHog = 0;			/* to signal the demise of a hog */
+int endChat = 0;		/* to signal the demise of the chatter */
+int endSleep = 0;		/* to signal the demise of the sleeper */
+volatile int stopLoad = FALSE;
+
+volatile unsigned int hogWork[HOGS];
+cpu_t sleepElapsed = 0;
+
+state_t hogState[HOGS], chatState, sleepState;
+
+void hog(int id) {
+
+	while (!stopLoad) {
+		hogWork[id]++;
+	}
+	
+	SYSCALL(VERHOGEN, (int)&endHog, 0, 0);
+	SYSCALL(TERMINATEPROCESS, 0, 0, 0);
+}
+
+void chatter() {
+
+	while (!stopLoad) {
+		benchPutChar('.');
+	}
+	benchPutChar('\n');
+	
+	SYSCALL(VERHOGEN, (int)&endChat, 0, 0);
+	SYSCALL(TERMINATEPROCESS, 0, 0, 0);
+}
+
+void sleeper() {
+
+	int i;
+	cpu_t start, stop;
+	
+	/* line up with a tick first */
+	SYSCALL(WAITFORCLOCK, 0, 0, 0);
+	STCK(start);
+	
+	for (i = 0; i < TICKS; i++) {
+		SYSCALL(WAITFORCLOCK, 0, 0, 0);
+	}
+	
+	STCK(stop);
+	sleepElapsed = stop - start;
+	
+	SYSCALL(VERHOGEN, (int)&endSleep, 0, 0);
+	SYSCALL(TERMINATEPROCESS, 0, 0, 0);
+}
+
+void test() {
+
+	int i;
+	cpu_t drift;
+	
+	benchPrint("clockBench: start\n");
+	
+	STST(&sleepState);
+	sleepState.s_sp = sleepState.s_sp - QPAGE;
+	sleepState.s_pc = (memaddr)sleeper;
+	
+	STST(&chatState);
+	chatState.s_sp = sleepState.s_sp - QPAGE;
+	chatState.s_pc = (memaddr)chatter;
+	
+	for (i = 0; i < HOGS; i++) {
+		hogWork[i] = 0;
+		
+		STST(&(hogState[i]));
+		hogState[i].s_sp = chatState.s_sp - ((i + 1) * QPAGE);
+		hogState[i].s_pc = (memaddr)hog;
+		hogState[i].s_a1 = i;
+	}
+	
+	for (i = 0; i < HOGS; i++) {
+		SYSCALL(CREATEPROCESS, (int)&(hogState[i]), 0, 0);
+	}
+	SYSCALL(CREATEPROCESS, (int)&chatState, 0, 0);
+	SYSCALL(CREATEPROCESS, (int)&sleepState, 0, 0);
+	
+	/* the load runs until the sleeper is done */
+	SYSCALL(PASSEREN, (int)&endSleep, 0, 0);
+	stopLoad = TRUE;
+	for (i = 0; i < HOGS; i++) {
+		SYSCALL(PASSEREN, (int)&endHog, 0, 0);
+	}
+	SYSCALL(PASSEREN, (int)&endChat, 0, 0);
+	
+	drift = sleepElapsed - (TICKS * INTERVALTIME);
+	if (drift < 0) {
+		drift = -drift;
+	}
+	
+	benchPrintNum("sleep elapsed (us): ", sleepElapsed);
+	benchPrintNum("drift over all ticks (us): ", drift);
+	benchPrintNum("skipped ticks: ", skippedTicks);
+	
+	for (i = 0; i < JITTERBUCKETS; i++) {
+		if (tickPeriods[i] > 0) {
+			benchPrintNum("tick period from (us): ", INTERVALTIME +
+						((i - (JITTERBUCKETS / 2)) << JITTERSHIFT));
+			benchPrintNum("  ticks: ", tickPeriods[i]);
+		}
+	}
+	benchPrint("clockBench: done\n");
+	
+	SYSCALL(TERMINATEPROCESS, 0, 0, 0);
+}
@@ -0,0 +1,157 @@
+/*********************************MEMBENCH.C****************************
+ *
+ *	Block memory benchmark for the JAEOS Kernel: phase 2.
+ *
+ *	Times the nucleus state copy and page copy, zero and compare, which
+ *	use multiple register loads and stores, against plain word at a
+ *	time loops doing the same work, and reports the average processor
+ *	cycles of one call of each, read from the low word of the TOD
+ *	clock.
+ *
+ *      Written by Jake Wagner
+ */
+
+#include "../../h/const.h"
+#include "../../h/types.h"
+
+#include "../../e/memops.e"
+#include "bench.e"
+
+#include "/usr/include/uarm/libuarm.h"
+
+#define CALLS		100
+#define PAGEWORDS	(PAGESIZE / WORDLEN)
+
+#define CYCLES()	(* ((unsigned int *) TODLOADDR))
+
+int pageA[PAGEWORDS], pageB[PAGEWORDS];
+state_t stateA, stateB;
+
+/* the word at a time versions */
+void loopState(state_t *source, state_t *target) {
+
+	int i;
+	
+	for (i = 0; i < STATEREGNUM; i++) {
+		target->s_reg[i] = source->s_reg[i];
+	}
+}
+
+void loopCopy(int *source, int *target) {
+
+	int i;
+	
+	for (i = 0; i < PAGEWORDS; i++) {
+		target[i] = source[i];
+	}
+}
+
+void loopZero(int *target) {
+
+	int i;
+	
+	for (i = 0; i < PAGEWORDS; i++) {
+		target[i] = 0;
+	}
+}
+
+int loopCompare(int *first, int *second) {
+
+	int i;
+	
+	for (i = 0; i < PAGEWORDS; i++) {
+		if (first[i] != second[i]) {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/* times CALLS of each operation with and without bursts */
+void runOps() {
+
+	int i;
+	unsigned int start;
+	
+	start = CYCLES();
+	for (i = 0; i < CALLS; i++) {
+		loopState(&stateA, &stateB);
+	}
+	benchPrintNum("state copy, word loop: ", (CYCLES() - start) / CALLS);
+	
+	start = CYCLES();
+	for (i = 0; i < CALLS; i++) {
+		moveState(&stateA, &stateB);
+	}
+	benchPrintNum("state copy, bursts: ", (CYCLES() - start) / CALLS);
+	
+	start = CYCLES();
+	for (i = 0; i < CALLS; i++) {
+		loopCopy(pageA, pageB);
+	}
+	benchPrintNum("page copy, word loop: ", (CYCLES() - start) / CALLS);
+	
+	start = CYCLES();
+	for (i = 0; i < CALLS; i++) {
+		copyPage(pageA, pageB);
+	}
+	benchPrintNum("page copy, bursts: ", (CYCLES() - start) / CALLS);
+	
+	/* the pages are equal, so every compare reads all of both */
+	start = CYCLES();
+	for (i = 0; i < CALLS; i++) {
+		loopCompare(pageA, pageB);
+	}
+	benchPrintNum("page compare, word loop: ", (CYCLES() - start) / CALLS);
+	
+	start = CYCLES();
+	for (i = 0; i < CALLS; i++) {
+		comparePage(pageA, pageB);
+	}
+	benchPrintNum("page compare, bursts: ", (CYCLES() - start) / CALLS);
+	
+	start = CYCLES();
+	for (i = 0; i < CALLS; i++) {
+		loopZero(pageB);
+	}
+	benchPrintNum("page zero, word loop: ", (CYCLES() - start) / CALLS);
+	
+	start = CYCLES();
+	for (i = 0; i < CALLS; i++) {
+		zeroPage(pageB);
+	}
+	benchPrintNum("page zero, bursts: ", (CYCLES() - start) / CALLS);
+}
+
+void test() {
+
+	int i;
+	
+	benchPrint("memBench: start\n");
+	
+	STST(&stateA);
+	for (i = 0; i < PAGEWORDS; i++) {
+		pageA[i] = i;
+	}
+	
+	runOps();
+	
+	/* check the burst versions against the loops */
+	copyPage(pageA, pageB);
+	if (!comparePage(pageA, pageB) || !loopCompare(pageA, pageB)) {
+		benchPrint("memBench: page copy ERROR\n");
+	}
+	pageB[PAGEWORDS - 1]++;
+	if (comparePage(pageA, pageB)) {
+		benchPrint("memBench: page compare ERROR\n");
+	}
+	zeroPage(pageB);
+	loopZero(pageA);
+	if (!comparePage(pageA, pageB)) {
+		benchPrint("memBench: page zero ERROR\n");
+	}
+	
+	benchPrint("memBench: done\n");
+	
+	SYSCALL(TERMINATEPROCESS, 0, 0, 0);
+}
@@ -0,0 +1,126 @@
+/*********************************PINGBENCH.C***************************
+ *
+ *	Ping-pong benchmark for the JAEOS Kernel: phase 2.
+ *
+ *	A pinger and a ponger pass a message back and forth over a pair of
+ *	semaphores while a few hog processes keep the ready queue full. The
+ *	exchange is run once with plain V operations and once with handoff
+ *	V operations, and the average round trip of each is reported.
+ *
+ *      Written by Jake Wagner
+ */
+
+#include "../../h/const.h"
+#include "../../h/types.h"
+
+#include "bench.e"
+
+#include "/usr/include/uarm/libuarm.h"
+
+#define QPAGE		1024
+
+#define HOGS		3
+#define ROUNDS		200
+
+int endHog = 0;			/* to signal the demise of a hog */
+int endPong = 0;		/* to signal the demise of the ponger */
+int endPing = 0;		/* to signal the demise of the pinger */
+volatile int stopHogs = FALSE;
+
+int pingSem = 0;		/* the pinger's message to the ponger */
+int pongSem = 0;		/* the ponger's answer to the pinger */
+int vCall;				/* the V used for this run */
+
+volatile unsigned int hogWork[HOGS];
+cpu_t roundTrip = 0;
+
+state_t hogState[HOGS], pingState, pongState;
+
+void hog(int id) {
+
+	while (!stopHogs) {
+		hogWork[id]++;
+	}
+	
+	SYSCALL(VERHOGEN, (int)&endHog, 0, 0);
+	SYSCALL(TERMINATEPROCESS, 0, 0, 0);
+}
+
+void ponger() {
+
+	int i;
+	
+	for (i = 0; i < ROUNDS; i++) {
+		SYSCALL(PASSEREN, (int)&pingSem, 0, 0);
+		SYSCALL(vCall, (int)&pongSem, 0, 0);
+	}
+	
+	SYSCALL(VERHOGEN, (int)&endPong, 0, 0);
+	SYSCALL(TERMINATEPROCESS, 0, 0, 0);
+}
+
+void pinger() {
+
+	int i;
+	cpu_t start, stop;
+	
+	STCK(start);
+	for (i = 0; i < ROUNDS; i++) {
+		SYSCALL(vCall, (int)&pingSem, 0, 0);
+		SYSCALL(PASSEREN, (int)&pongSem, 0, 0);
+	}
+	STCK(stop);
+	
+	roundTrip = (stop - start) / ROUNDS;
+	
+	SYSCALL(VERHOGEN, (int)&endPing, 0, 0);
+	SYSCALL(TERMINATEPROCESS, 0, 0, 0);
+}
+
+/* runs the ping-pong against the hogs with the given V */
+cpu_t pingPong(int call) {
+
+	int i;
+	
+	vCall = call;
+	stopHogs = FALSE;
+	
+	STST(&pingState);
+	pingState.s_sp = pingState.s_sp - QPAGE;
+	pingState.s_pc = (memaddr)pinger;
+	
+	STST(&pongState);
+	pongState.s_sp = pingState.s_sp - QPAGE;
+	pongState.s_pc = (memaddr)ponger;
+	
+	for (i = 0; i < HOGS; i++) {
+		STST(&(hogState[i]));
+		hogState[i].s_sp = pongState.s_sp - ((i + 1) * QPAGE);
+		hogState[i].s_pc = (memaddr)hog;
+		hogState[i].s_a1 = i;
+		SYSCALL(CREATEPROCESS, (int)&(hogState[i]), 0, 0);
+	}
+	SYSCALL(CREATEPROCESS, (int)&pongState, 0, 0);
+	SYSCALL(CREATEPROCESS, (int)&pingState, 0, 0);
+	
+	/* the hogs run until the exchange is done */
+	SYSCALL(PASSEREN, (int)&endPing, 0, 0);
+	SYSCALL(PASSEREN, (int)&endPong, 0, 0);
+	stopHogs = TRUE;
+	for (i = 0; i < HOGS; i++) {
+		SYSCALL(PASSEREN, (int)&endHog, 0, 0);
+	}
+	
+	return roundTrip;
+}
+
+void test() {
+
+	benchPrint("pingBench: start\n");
+	
+	benchPrintNum("round trip with V (us): ", pingPong(VERHOGEN));
+	benchPrintNum("round trip with handoff (us): ", pingPong(HANDOFF));
+	benchPrint("pingBench: done\n");
+	
+	SYSCALL(TERMINATEPROCESS, 0, 0, 0);
+}
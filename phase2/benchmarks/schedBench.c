@@ -0,0 +1,135 @@
+/*********************************SCHEDBENCH.C**************************
+ *
+ *	Scheduler benchmark for the JAEOS Kernel: phase 2.
+ *
+ *	Runs a few CPU bound hog processes against one interactive process
+ *	that writes characters to Terminal0 one at a time. It reports how
+ *	long each write took to come back (the interactive latency) and
+ *	how much work the hogs got done in the meantime (the throughput).
+ *
+ *	Build the kernel with KFLAGS=-DMLFQLEVELS=1 to get the old single
+ *	round robin ready queue to compare against.
+ *
+ *      Written by Jake Wagner
+ */
+
+#include "../../h/const.h"
+#include "../../h/types.h"
+
+#include "bench.e"
+
+#include "/usr/include/uarm/libuarm.h"
+
+#define QPAGE		1024
+
+#define HOGS		3
+#define PINGS		60
+
+int endHog = 0;			/* to signal the demise of a hog */
+int endPing = 0;		/* to signal the demise of the pinger */
+volatile int stopHogs = FALSE;
+
+volatile unsigned int hogWork[HOGS];
+cpu_t pingTotal = 0;
+cpu_t pingMax = 0;
+
+state_t hogState[HOGS], pingState;
+
+void hog(int id) {
+
+	while (!stopHogs) {
+		hogWork[id]++;
+	}
+	
+	SYSCALL(VERHOGEN, (int)&endHog, 0, 0);
+	SYSCALL(TERMINATEPROCESS, 0, 0, 0);
+}
+
+void pinger() {
+
+	int i;
+	cpu_t latency;
+	
+	for (i = 0; i < PINGS; i++) {
+		latency = benchPutChar('.');
+		
+		pingTotal = pingTotal + latency;
+		if (latency > pingMax) {
+			pingMax = latency;
+		}
+	}
+	benchPutChar('\n');
+	
+	SYSCALL(VERHOGEN, (int)&endPing, 0, 0);
+	SYSCALL(TERMINATEPROCESS, 0, 0, 0);
+}
+
+void test() {
+
+	int i;
+	unsigned int work = 0;
+	cpu_t start, stop;
+	int times[NUMACCTS];
+	loadinfo_t load;
+	unsigned int latency[LATBUCKETS];
+	
+	benchPrintNum("schedBench: ready queue levels ", MLFQLEVELS);
+	
+	STST(&pingState);
+	pingState.s_sp = pingState.s_sp - QPAGE;
+	pingState.s_pc = (memaddr)pinger;
+	
+	for (i = 0; i < HOGS; i++) {
+		hogWork[i] = 0;
+		
+		STST(&(hogState[i]));
+		hogState[i].s_sp = pingState.s_sp - ((i + 1) * QPAGE);
+		hogState[i].s_pc = (memaddr)hog;
+		hogState[i].s_a1 = i;
+	}
+	
+	STCK(start);
+	
+	for (i = 0; i < HOGS; i++) {
+		SYSCALL(CREATEPROCESS, (int)&(hogState[i]), 0, 0);
+	}
+	SYSCALL(CREATEPROCESS, (int)&pingState, 0, 0);
+	
+	/* the hogs run until the pinger is done */
+	SYSCALL(PASSEREN, (int)&endPing, 0, 0);
+	stopHogs = TRUE;
+	for (i = 0; i < HOGS; i++) {
+		SYSCALL(PASSEREN, (int)&endHog, 0, 0);
+	}
+	
+	STCK(stop);
+	
+	for (i = 0; i < HOGS; i++) {
+		work = work + hogWork[i];
+	}
+	
+	benchPrintNum("write latency avg (us): ", pingTotal / PINGS);
+	benchPrintNum("write latency max (us): ", pingMax);
+	benchPrintNum("elapsed (us): ", stop - start);
+	benchPrintNum("hog work per ms: ", work / ((stop - start) / 1000 + 1));
+	
+	SYSCALL(GETTIMES, (int)&(times[0]), 0, 0);
+	benchPrintNum("interrupt time (us): ", times[ACCTINT]);
+	benchPrintNum("idle time (us): ", times[ACCTIDLE]);
+	benchPrintNum("nucleus time (us): ", times[ACCTKERNEL]);
+	
+	SYSCALL(GETLOAD, (int)&load, 0, 0);
+	benchPrintNum("load average 1 min (thousandths): ",
+						(load.l_avg[0] * 1000) >> LOADSHIFT);
+	
+	SYSCALL(GETLATENCY, TARGETSYSTEM, (int)&(latency[0]), FALSE);
+	for (i = 0; i < LATBUCKETS; i++) {
+		if (latency[i] > 0) {
+			benchPrintNum("ready to run under (us): ", LATBASE << i);
+			benchPrintNum("  dispatches: ", latency[i]);
+		}
+	}
+	benchPrint("schedBench: done\n");
+	
+	SYSCALL(TERMINATEPROCESS, 0, 0, 0);
+}
@@ -0,0 +1,100 @@
+/*********************************SHAREBENCH.C**************************
+ *
+ *	Fair share benchmark for the JAEOS Kernel: phase 2.
+ *
+ *	Two tenant processes with the same number of tickets each spawn
+ *	CPU bound children, one child for tenant A and four for tenant B.
+ *	After a few pseudo clock ticks each tenant reports the CPU share
+ *	its subtree used against the share its tickets entitle it to. With
+ *	per-subtree stride scheduling both should be close to one half.
+ *
+ *      Written by Jake Wagner
+ */
+
+#include "../../h/const.h"
+#include "../../h/types.h"
+
+#include "bench.e"
+
+#include "/usr/include/uarm/libuarm.h"
+
+#define QPAGE		1024
+
+#define TENANTS		2
+#define MAXHOGS		4
+#define RUNTICKS	20
+
+int reportSem[TENANTS];		/* to ask a tenant for its report */
+int endReport = 0;			/* to signal a tenant has reported */
+int holdTenants = 0;		/* to keep tenants around until the end */
+
+int tenantHogs[TENANTS] = {1, MAXHOGS};
+char *tenantName[TENANTS] = {"tenant A", "tenant B"};
+
+state_t tenantState[TENANTS], hogState[TENANTS][MAXHOGS];
+
+void hog() {
+
+	for (;;) {
+		;
+	}
+}
+
+void tenant(int id) {
+
+	int i;
+	int report[2];
+	
+	for (i = 0; i < tenantHogs[id]; i++) {
+		STST(&(hogState[id][i]));
+		hogState[id][i].s_sp = tenantState[id].s_sp - ((i + 1) * QPAGE);
+		hogState[id][i].s_pc = (memaddr)hog;
+		
+		SYSCALL(CREATEPROCESS, (int)&(hogState[id][i]), 0, 0);
+	}
+	
+	SYSCALL(PASSEREN, (int)&(reportSem[id]), 0, 0);
+	
+	SYSCALL(GETSHARE, TARGETSELF, (int)report, 0);
+	benchPrint(tenantName[id]);
+	benchPrintNum(" share: ", report[0]);
+	benchPrintNum("  target: ", report[1]);
+	
+	SYSCALL(VERHOGEN, (int)&endReport, 0, 0);
+	
+	/* stay alive so the other tenant's share is measured against us */
+	SYSCALL(PASSEREN, (int)&holdTenants, 0, 0);
+}
+
+void test() {
+
+	int i;
+	
+	benchPrint("shareBench: shares in thousandths\n");
+	
+	for (i = 0; i < TENANTS; i++) {
+		reportSem[i] = 0;
+		
+		STST(&(tenantState[i]));
+		tenantState[i].s_sp = tenantState[i].s_sp - 
+										((i * (MAXHOGS + 1) + 1) * QPAGE);
+		tenantState[i].s_pc = (memaddr)tenant;
+		tenantState[i].s_a1 = i;
+		
+		SYSCALL(CREATEPROCESS, (int)&(tenantState[i]), 0, 0);
+	}
+	
+	for (i = 0; i < RUNTICKS; i++) {
+		SYSCALL(WAITFORCLOCK, 0, 0, 0);
+	}
+	
+	for (i = 0; i < TENANTS; i++) {
+		SYSCALL(VERHOGEN, (int)&(reportSem[i]), 0, 0);
+		SYSCALL(PASSEREN, (int)&endReport, 0, 0);
+	}
+	
+	benchPrint("shareBench: done\n");
+	
+	/* take the tenants and their hogs down too */
+	SYSCALL(TERMINATEPROCESS, 0, 0, 0);
+}
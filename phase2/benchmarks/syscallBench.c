@@ -0,0 +1,71 @@
+/*********************************SYSCALLBENCH.C************************
+ *
+ *	Syscall cost benchmark for the JAEOS Kernel: phase 2.
+ *
+ *	Times a long run of each of the syscalls that return straight to
+ *	the caller, a V with no waiter, a P that does not block and a get
+ *	CPU time, and reports the average cost of one call of each. No
+ *	other process is ready, so the calls are never preempted.
+ *
+ *	The V and P runs are done once through the fast path entry and
+ *	once with the syscall new area pointed straight at the C handler.
+ *
+ *      Written by Jake Wagner
+ */
+
+#include "../../h/const.h"
+#include "../../h/types.h"
+
+#include "../../e/exceptions.e"
+#include "../../e/fastpath.e"
+#include "bench.e"
+
+#include "/usr/include/uarm/libuarm.h"
+
+#define CALLS		2000
+
+int benchSem = 0;		/* never has a waiter */
+
+/* times CALLS of the given syscall on benchSem */
+cpu_t callCost(int call) {
+
+	int i;
+	cpu_t start, stop;
+	
+	STCK(start);
+	for (i = 0; i < CALLS; i++) {
+		SYSCALL(call, (int)&benchSem, 0, 0);
+	}
+	STCK(stop);
+	
+	return (stop - start) / CALLS;
+}
+
+void test() {
+
+	state_t *sysCallNew = (state_t *) SYSCALLNEWADDR;
+	
+	benchPrint("syscallBench: start\n");
+	
+	/* the Ps take back the units of the Vs, so none blocks */
+	sysCallNew->s_pc = (memaddr) sysCallEntry;
+	benchPrintNum("V without a waiter, fast path (us): ", 
+												callCost(VERHOGEN));
+	benchPrintNum("P without blocking, fast path (us): ", 
+												callCost(PASSEREN));
+	
+	sysCallNew->s_pc = (memaddr) sysCallHandler;
+	benchPrintNum("V without a waiter, C handler (us): ", 
+												callCost(VERHOGEN));
+	benchPrintNum("P without blocking, C handler (us): ", 
+												callCost(PASSEREN));
+	benchPrintNum("get CPU time (us): ", callCost(GETCPUTIME));
+	
+	/* put back the entry the kernel was built with */
+	if (FASTSYSCALL) {
+		sysCallNew->s_pc = (memaddr) sysCallEntry;
+	}
+	benchPrint("syscallBench: done\n");
+	
+	SYSCALL(TERMINATEPROCESS, 0, 0, 0);
+}
@@ -17,7 +17,12 @@
 * time for a process, have a process wait for the clock and have a
 * process wait for I/O.
 * 
-* If the syscall is between 9 and 255, it is passed up or killed as a 
+* The extended nucleus services from 32 to 47 are privileged the same
+* way. They can set the static priority or the CPU tickets of a process,
+* report the CPU share of its subtree and move it into the earliest
+* deadline first real time class.
+* 
+* Any other syscall between 9 and 255 is passed up or killed as a 
 * system trap.
 *
 * Written by Jake Wagner
@@ -32,6 +37,8 @@
 #include "../e/exceptions.e"
 #include "../e/scheduler.e"
 #include "../e/initial.e"
+#include "../e/interrupts.e"
+#include "../e/memops.e"
 
 #include "/usr/include/uarm/libuarm.h"
 
@@ -49,6 +56,9 @@
 void progTrpHandler(){
 	
 	state_t* oldState = (state_t*) PROGTRPOLDADDR;
+	
+	/*From here on the process is charged system time*/
+	switchAccount(ACCTSYS);
 		
 	/*Call a Program Trap Pass Up or Die*/
 	passUpOrDie(PROGTRAP);
@@ -64,6 +74,9 @@ void tlbHandler(){
 	
 	state_t* oldState = (state_t*) TLBOLDADDR;
 	debugA(oldState->s_CP15_Cause & CAUSEMASK);
+	
+	/*From here on the process is charged system time*/
+	switchAccount(ACCTSYS);
 		
 	/*Call a TLB Trap Pass Up or Die*/
 	passUpOrDie(TLBTRAP);
@@ -74,7 +87,11 @@ void tlbHandler(){
  *Function that handles all syscall exceptions from syscall 1-255. 
  *It handles each different call with a switch statement based on the 
  *syscall number that is stored as a parameter in the sysCallOld area in
- *low memory.
+ *low memory. The state is left in the sysCallOld area and a call that
+ *returns to the caller loads it from there, so it is only copied into
+ *the pcb when the caller blocks or gives up the CPU. Uncontended P and
+ *V operations from system mode are finished by sysCallEntry() and
+ *never get here.
  *RETURNS: Varies based on Syscall Number
  **********************************************************************/
 void sysCallHandler(){
@@ -84,8 +101,6 @@ void sysCallHandler(){
 	pcb_PTR process = NULL;
 	int *semAdd;
 	int semDev;
-	cpu_t elapsedTime;
-	cpu_t stopTOD;
 	state_t *sysCallOld;
 	state_t *progTrpOld;
 	int system = FALSE;
@@ -97,11 +112,11 @@ void sysCallHandler(){
 	/*Increment PC by 8*/
 	oldState->s_pc = oldState->s_pc + 8;
 	
-	/*Move the old state into the current process*/
-	moveState(oldState, &(currentProcess->p_s));
+	/*From here on the process is charged system time*/
+	switchAccount(ACCTSYS);
 	
 	/*If the state was in system mode...*/
-	if((currentProcess->p_s.s_cpsr & SYSTEMMODE) == SYSTEMMODE){
+	if((oldState->s_cpsr & SYSTEMMODE) == SYSTEMMODE){
 		system = TRUE;
 	}
 	
@@ -132,11 +147,17 @@ void sysCallHandler(){
 					moveState((state_t *) oldState->s_a2, 
 														&(newPcb->p_s));
 					
+					/*The child inherits its parent's priority*/
+					newPcb->p_prio = currentProcess->p_prio;
+					newPcb->p_quantumLeft = quantumOf(newPcb);
+					
 					/*Make it a child of current process and add it to
 					 *the ready queue
 					 */
 					insertChild(currentProcess, newPcb);
-					insertProcQ(&(readyQueue), newPcb);	
+					joinSiblings(newPcb);
+					makeReady(newPcb);
+					rearmTimer();
 				}
 				
 				/*The free list was empty*/
@@ -147,7 +168,7 @@ void sysCallHandler(){
 				}
 				
 				/*Return to current process*/				
-				headBackHome();
+				headBackHome(oldState);
 				break;
 				
 			/***********************************************************
@@ -186,20 +207,30 @@ void sysCallHandler(){
 					process->p_semAdd = NULL;
 					
 					/*Add it to the ready queue*/
-					insertProcQ(&(readyQueue), process);
+					makeReady(process);
+					
+					/*If it is a more urgent real time job, switch*/
+					if(shouldPreempt()){
+						switchAccount(ACCTSYS);
+						saveState();
+						preempt();
+					}
+					
+					/*If the current process was running alone...*/
+					rearmTimer();
 				}
 
 				/*Return to current process*/
-				headBackHome();
+				headBackHome(oldState);
 				break;
 
 			/***********************************************************
 			 *Syscall 4
 			 *This syscall performs a P operation on the specified
 			 *semaphore. If the semaphore is less than zero, it stores
-			 *the elapsed time, subtracts the elapsed time from the time
-			 *to the next psuedo clock tick, blocks the process, and 
-			 *then calls to get a new job. Otherwise, it returns to the 
+			 *the elapsed time, gives the process a whole quantum for
+			 *its next turn, blocks the process, and then calls to get
+			 *a new job. Otherwise, it returns to the 
 			 *current process.
 			 **********************************************************/
 			case PASSEREN:
@@ -211,16 +242,16 @@ void sysCallHandler(){
 												
 				if(*semAdd < 0){
 										
-					/*Store ending TOD*/
-					STCK(stopTOD);
+					/*Charge the time so far as system time*/
+					switchAccount(ACCTSYS);
 					
-					/*Store elapsed time*/
-					elapsedTime = stopTOD - startTOD;
-					currentProcess->p_time = currentProcess->p_time 
-														+ elapsedTime;
-					timeLeft = timeLeft - elapsedTime;
+					/*Blocking early earns a shorter, higher queue*/
+					promote(currentProcess);
+					currentProcess->p_quantumLeft = 
+										quantumOf(currentProcess);
 					
 					/*Block the currentProcess*/
+					saveState();
 					insertBlocked(semAdd, currentProcess);
 					currentProcess = NULL;
 										
@@ -229,7 +260,7 @@ void sysCallHandler(){
 				}
 				
 				/*Return to current process*/
-				headBackHome();
+				headBackHome(oldState);
 				break;
 			
 			/***********************************************************
@@ -246,38 +277,29 @@ void sysCallHandler(){
 			/***********************************************************
 			 *Syscall 6
 			 *This syscall returns the current CPU time that a process
-			 *has been using since its creation and stores it into v0.
-			 *It also subracts the elapsed time from the time to next
-			 *pseudo clock tick.
+			 *has been using since its creation, user and system time
+			 *together, and stores it into v0.
 			 **********************************************************/
 			case GETCPUTIME:
 			
-				/*Store ending TOD*/
-				STCK(stopTOD);
-				
-				/*Store elapsed time*/
-				elapsedTime = stopTOD - startTOD;
-				currentProcess->p_time = currentProcess->p_time 
-													+ elapsedTime;
-				timeLeft = timeLeft - elapsedTime;
+				/*Charge the time so far as system time*/
+				switchAccount(ACCTSYS);
 				
 				/*Copy current process time into return register*/		
-				currentProcess->p_s.s_a1 = currentProcess->p_time;
-				
-				/*Store starting TOD*/
-				STCK(startTOD);
+				oldState->s_a1 = 
+								todToMicros(currentProcess->p_time);
 				
 				/*Return to previous process*/
-				headBackHome();
+				headBackHome(oldState);
 				break;
 				
 			/***********************************************************
 			 *Syscall 7
 			 *This syscall performs a P operation on the clock 
 			 *semaphore. If the semaphore is less than zero, it stores
-			 *the elapsed time, subtracts the elapsed time from the time
-			 *to the next psuedo clock tick, blocks the process, and 
-			 *then calls to get a new job. Otherwise, it returns to the 
+			 *the elapsed time, gives the process a whole quantum for
+			 *its next turn, blocks the process, and then calls to get
+			 *a new job. Otherwise, it returns to the 
 			 *current process.
 			 **********************************************************/			
 			case WAITFORCLOCK:
@@ -288,16 +310,13 @@ void sysCallHandler(){
 				semaphoreArray[semDev] = semaphoreArray[semDev] - 1;
 				if(semaphoreArray[semDev] < 0){
 										
-					/*Store ending TOD*/
-					STCK(stopTOD);
-					
-					/*Store elapsed time*/
-					elapsedTime = stopTOD - startTOD;
-					currentProcess->p_time = currentProcess->p_time 
-														+ elapsedTime;
-					timeLeft = timeLeft - elapsedTime;
+					/*Charge the time so far as system time*/
+					switchAccount(ACCTSYS);
+					currentProcess->p_quantumLeft = 
+										quantumOf(currentProcess);
 					
 					/*Block the process*/
+					saveState();
 					insertBlocked(&(semaphoreArray[semDev]), 
 												currentProcess);
 					currentProcess = NULL;
@@ -315,9 +334,9 @@ void sysCallHandler(){
 			 *Syscall 8
 			 *This syscall performs a P operation on the specified
 			 *device semaphore. If the semaphore is less than zero, it 
-			 *stores the elapsed time, subtracts the elapsed time from
-			 *the time to the next pseudo clock tick, blocks the 
-			 *process, and then calls to get a new job. Otherwise, it 
+			 *stores the elapsed time, gives the process a whole
+			 *quantum for its next turn, blocks the process, and then
+			 *calls to get a new job. Otherwise, it 
 			 *returns to the current process.
 			 **********************************************************/
 			case WAITFORIO:
@@ -336,15 +355,16 @@ void sysCallHandler(){
 
 				if(semaphoreArray[semDev] < 0){
 										
-					/*Store ending TOD*/
-					STCK(stopTOD);
+					/*Charge the time so far as system time*/
+					switchAccount(ACCTSYS);
 					
-					elapsedTime = stopTOD - startTOD;
-					currentProcess->p_time = currentProcess->p_time 
-														+ elapsedTime;
-					timeLeft = timeLeft - elapsedTime;
+					/*Blocking early earns a shorter, higher queue*/
+					promote(currentProcess);
+					currentProcess->p_quantumLeft = 
+										quantumOf(currentProcess);
 					
 					/*Block the process*/
+					saveState();
 					insertBlocked(&(semaphoreArray[semDev]), 
 												currentProcess);
 					currentProcess = NULL;
@@ -354,9 +374,160 @@ void sysCallHandler(){
 					getNewJob();
 				}
 				else {
-					currentProcess->p_s.s_a1 = devStatus[semDev];
-					headBackHome();
+					
+					/*The completion came first, so take its status*/
+					oldState->s_a1 = popStatus(semDev);
+					headBackHome(oldState);
+				}
+				break;
+				
+			/***********************************************************
+			 *Syscall 32
+			 *This syscall sets the static priority of the current
+			 *process or of its most recently created child to the
+			 *priority in a2. It returns whether or not it was
+			 *successful.
+			 **********************************************************/
+			case SETPRIORITY:
+				
+				oldState->s_a1 = setPriority(oldState->s_a2, 
+														oldState->s_a3);
+				
+				/*Return to current process*/
+				headBackHome(oldState);
+				break;
+				
+			/***********************************************************
+			 *Syscall 33
+			 *This syscall sets the CPU tickets of the current process
+			 *or of its most recently created child to the number in
+			 *a2. It returns whether or not it was successful.
+			 **********************************************************/
+			case SETTICKETS:
+				
+				oldState->s_a1 = setTickets(oldState->s_a2, 
+														oldState->s_a3);
+				
+				/*Return to current process*/
+				headBackHome(oldState);
+				break;
+				
+			/***********************************************************
+			 *Syscall 34
+			 *This syscall reports the CPU share the subtree of the
+			 *current process or of its most recently created child has
+			 *used among its siblings, and the share its tickets entitle
+			 *it to, both in thousandths, into the two words at a3.
+			 **********************************************************/
+			case GETSHARE:
+				
+				oldState->s_a1 = getShare(oldState->s_a2, 
+											   (int *) oldState->s_a3);
+				
+				/*Return to current process*/
+				headBackHome(oldState);
+				break;
+				
+			/***********************************************************
+			 *Syscall 35
+			 *This syscall moves the current process or its most
+			 *recently created child into the real time class with the
+			 *period in a2 and the budget in a3, both in microseconds.
+			 *A period of zero moves it back to the normal class. It
+			 *returns whether or not it was admitted.
+			 **********************************************************/
+			case SETREALTIME:
+				
+				oldState->s_a1 = setRealTime(oldState->s_a2, 
+										oldState->s_a3, oldState->s_a4);
+				
+				/*Return to current process*/
+				headBackHome(oldState);
+				break;
+				
+			/***********************************************************
+			 *Syscall 36
+			 *This syscall performs a V operation on the specified
+			 *semaphore like Syscall 3, except that a process it
+			 *unblocks is switched to straight away and runs on what is
+			 *left of the current process's quantum. The current process
+			 *goes back on the ready queue.
+			 **********************************************************/
+			case HANDOFF:
+				
+				semAdd = (int *) oldState->s_a2;
+				
+				/*Increment semaphore address*/
+				*semAdd = *semAdd + 1;
+				
+				if(*semAdd <= 0){
+					
+					/*Unblock the next process*/
+					process = removeBlocked(semAdd);
+					process->p_semAdd = NULL;
+					
+					/*Charge the current process up to the switch*/
+					switchAccount(ACCTSYS);
+					
+					/*Switch to it, if it can go ahead of the others*/
+					saveState();
+					handOff(process);
+					
+					/*It was only made ready, so finish like a V*/
+					if(shouldPreempt()){
+						preempt();
+					}
+					rearmTimer();
 				}
+				
+				/*Return to current process*/
+				headBackHome(oldState);
+				break;
+				
+			/***********************************************************
+			 *Syscall 37
+			 *This syscall stores the user and system time of the
+			 *current process and the interrupt, idle and nucleus time
+			 *of the processor, all in microseconds, into the array of
+			 *NUMACCTS words at a2, indexed by account.
+			 **********************************************************/
+			case GETTIMES:
+				
+				getTimes((int *) oldState->s_a2);
+				
+				/*Return to current process*/
+				headBackHome(oldState);
+				break;
+				
+			/***********************************************************
+			 *Syscall 38
+			 *This syscall brings the load statistics up to the last
+			 *pseudo clock tick and copies them into the loadinfo_t at
+			 *a2.
+			 **********************************************************/
+			case GETLOAD:
+				
+				getLoad((loadinfo_t *) oldState->s_a2);
+				
+				/*Return to current process*/
+				headBackHome(oldState);
+				break;
+				
+			/***********************************************************
+			 *Syscall 39
+			 *This syscall copies the ready to run latency histogram of
+			 *the current process, its most recently created child or
+			 *the whole system, as chosen by a2, into the array of
+			 *LATBUCKETS words at a3 and clears it if a4 is TRUE. It
+			 *returns whether or not the target was valid.
+			 **********************************************************/
+			case GETLATENCY:
+				
+				oldState->s_a1 = getLatency(oldState->s_a2, 
+						(unsigned int *) oldState->s_a3, oldState->s_a4);
+				
+				/*Return to current process*/
+				headBackHome(oldState);
 				break;
 				
 			/***********************************************************
@@ -375,8 +546,9 @@ void sysCallHandler(){
 	
 	/*The process was not in system mode*/
 	
-	/*If it was a Syscall 1-8...*/
-	if(sysCallNum >= CREATEPROCESS && sysCallNum <= WAITFORIO){
+	/*If it was a Syscall 1-8 or an extended nucleus service...*/
+	if((sysCallNum >= CREATEPROCESS && sysCallNum <= WAITFORIO) || 
+			(sysCallNum >= EXTSYSSTART && sysCallNum <= EXTSYSEND)){
 		
 		/*Get the new areas in memory*/
 		sysCallOld = (state_t *) SYSCALLOLDADDR;
@@ -422,11 +594,9 @@ void passUpOrDie(int type){
 				/*Move the areas around*/
 				moveState((state_t *) PROGTRPOLDADDR, 
 											(currentProcess->oldPrgm));
-				moveState(currentProcess->newPrgm, 
-												&(currentProcess->p_s));
 				
-				/*Return to the current process*/
-				headBackHome();
+				/*Return to the current process in its handler*/
+				headBackHome(currentProcess->newPrgm);
 			}
 			break;
 		
@@ -438,11 +608,9 @@ void passUpOrDie(int type){
 				/*Move the areas around*/
 				moveState((state_t *) TLBOLDADDR, 
 											(currentProcess->oldTlb));
-				moveState(currentProcess->newTlb, 
-											&(currentProcess->p_s));	
 				
-				/*Return to current process*/
-				headBackHome();
+				/*Return to current process in its handler*/
+				headBackHome(currentProcess->newTlb);
 			}
 			break;
 			
@@ -454,11 +622,9 @@ void passUpOrDie(int type){
 				/*Move the areas around*/
 				moveState((state_t *) SYSCALLOLDADDR, 
 											(currentProcess->oldSys));
-				moveState(currentProcess->newSys,
-												&(currentProcess->p_s));
 				
-				/*Return to current process*/
-				headBackHome();
+				/*Return to current process in its handler*/
+				headBackHome(currentProcess->newSys);
 			}
 			break;
 	
@@ -493,7 +659,7 @@ void sysFiveHandle(int type){
 				currentProcess->newTlb = (state_t *)oldState->s_a4;
 				
 				/*Return to current process*/
-				headBackHome();
+				headBackHome(oldState);
 			}
 			
 		case PROGTRAP:
@@ -506,7 +672,7 @@ void sysFiveHandle(int type){
 				currentProcess->newPrgm = (state_t *)oldState->s_a4;
 				
 				/*Return to current process*/
-				headBackHome();
+				headBackHome(oldState);
 			}
 			
 		case SYSTRAP:
@@ -519,7 +685,7 @@ void sysFiveHandle(int type){
 				currentProcess->newSys = (state_t *)oldState->s_a4;
 				
 				/*Return to current process*/
-				headBackHome();
+				headBackHome(oldState);
 			}
 	}
 	
@@ -529,14 +695,292 @@ void sysFiveHandle(int type){
 }
 
 /***********************************************************************
- *Function that performs the LDST instruction to load the current
- *process state into the processor.
+ *Function that handles a syscall 32 system call. It sets the static
+ *priority of the current process, or of its most recently created
+ *child, which is moved to its new ready queue if it is ready.
+ *RETURNS: SUCCESS or FAILURE if the priority or the target is not valid
+ **********************************************************************/
+int setPriority(int prio, int target){
+	
+	pcb_PTR process = currentProcess;
+	
+	/*If the priority does not exist...*/
+	if((prio < 0) || (prio >= NUMPRIO)){
+		return FAILURE;
+	}
+	
+	/*If it is the child's priority being set...*/
+	if(target == TARGETCHILD){
+		process = currentProcess->p_child;
+		
+		if(process == NULL){
+			return FAILURE;
+		}
+	}
+	else if(target != TARGETSELF){
+		return FAILURE;
+	}
+	
+	/*If the process is on a normal ready queue, requeue it, a real time
+	 *job's queue does not depend on its priority*/
+	if((process != currentProcess) && (process->p_semAdd == NULL) &&
+											(process->p_period == 0)){
+		outReady(process);
+		process->p_prio = prio;
+		makeReady(process);
+	}
+	else{
+		process->p_prio = prio;
+	}
+	
+	return SUCCESS;
+}
+
+/***********************************************************************
+ *Function that handles a syscall 33 system call. It sets the CPU
+ *tickets of the current process, or of its most recently created
+ *child, which changes how quickly its subtree's pass value grows.
+ *RETURNS: SUCCESS or FAILURE if the tickets or the target is not valid
+ **********************************************************************/
+int setTickets(int tickets, int target){
+	
+	pcb_PTR process = currentProcess;
+	
+	/*If the number of tickets is out of range...*/
+	if((tickets < 1) || (tickets > MAXTICKETS)){
+		return FAILURE;
+	}
+	
+	/*If it is the child's tickets being set...*/
+	if(target == TARGETCHILD){
+		process = currentProcess->p_child;
+		
+		if(process == NULL){
+			return FAILURE;
+		}
+	}
+	else if(target != TARGETSELF){
+		return FAILURE;
+	}
+	
+	process->p_tickets = tickets;
+	process->p_stride = (STRIDESCALE << STRIDESHIFT) / tickets;
+	return SUCCESS;
+}
+
+/***********************************************************************
+ *Function that handles a syscall 34 system call. It measures the CPU
+ *share of the subtree of the current process, or of its most recently
+ *created child, from the subtree times of it and its siblings and
+ *compares it to the share its tickets entitle it to.
+ *RETURNS: SUCCESS or FAILURE if the target is not valid
+ **********************************************************************/
+int getShare(int target, int *report){
+	
+	pcb_PTR process = currentProcess;
+	pcb_PTR sib;
+	tod_t totalTime = 0;
+	tod_t treeTime;
+	int totalTickets = 0;
+	
+	/*If it is the child's share being reported...*/
+	if(target == TARGETCHILD){
+		process = currentProcess->p_child;
+	}
+	else if(target != TARGETSELF){
+		return FAILURE;
+	}
+	
+	if(process == NULL){
+		return FAILURE;
+	}
+	
+	/*If the process has no parent it has the whole CPU*/
+	if(process->p_prnt == NULL){
+		report[0] = SHARESCALE;
+		report[1] = SHARESCALE;
+		return SUCCESS;
+	}
+	
+	/*Total up the process and its siblings*/
+	for(sib = process->p_prnt->p_child; sib != NULL; 
+												sib = sib->p_prevSib){
+		totalTime = totalTime + sib->p_treeTime;
+		totalTickets = totalTickets + sib->p_tickets;
+	}
+	
+	/*Shift both times down until the share can be worked out with a
+	 *single word division*/
+	treeTime = process->p_treeTime;
+	while(totalTime >= (1 << SHAREBITS)){
+		totalTime = totalTime >> 1;
+		treeTime = treeTime >> 1;
+	}
+	
+	if(totalTime > 0){
+		report[0] = ((unsigned int) treeTime * SHARESCALE) / 
+										(unsigned int) totalTime;
+	}
+	else{
+		report[0] = 0;
+	}
+	report[1] = (process->p_tickets * SHARESCALE) / totalTickets;
+	
+	return SUCCESS;
+}
+
+/***********************************************************************
+ *Function that handles a syscall 35 system call. It moves the current
+ *process, or its most recently created child, into or out of the real
+ *time class, requeueing the child if it is ready. A throttled job that
+ *stays real time is held back until its current period ends.
+ *RETURNS: SUCCESS or FAILURE if the target is not valid or the job
+ *could not be admitted
+ **********************************************************************/
+int setRealTime(cpu_t period, cpu_t budget, int target){
+	
+	pcb_PTR process = currentProcess;
+	int ready;
+	int status;
+	tod_t release;
+	
+	/*If it is the child being moved...*/
+	if(target == TARGETCHILD){
+		process = currentProcess->p_child;
+		
+		if(process == NULL){
+			return FAILURE;
+		}
+	}
+	else if(target != TARGETSELF){
+		return FAILURE;
+	}
+	
+	/*A held back job that stays real time waits out its period on the
+	 *throttle queue with the new period and budget*/
+	if(process->p_throttled && (period > 0)){
+		release = process->p_deadline;
+		status = admitRealTime(process, period, budget);
+		process->p_deadline = release;
+		return status;
+	}
+	
+	/*Take the child off the ready queue while its class changes*/
+	ready = ((process != currentProcess) && (process->p_semAdd == NULL));
+	if(ready){
+		outReady(process);
+	}
+	
+	status = admitRealTime(process, period, budget);
+	
+	if(ready){
+		makeReady(process);
+	}
+	
+	return status;
+}
+
+/***********************************************************************
+ *Function that handles a syscall 37 system call. It brings the current
+ *process's time up to date and reports every CPU time account.
+ *RETURNS: N/a
+ **********************************************************************/
+void getTimes(int *report){
+	
+	switchAccount(ACCTSYS);
+	
+	report[ACCTUSER] = todToMicros(currentProcess->p_time - 
+										currentProcess->p_sysTime);
+	report[ACCTSYS] = todToMicros(currentProcess->p_sysTime);
+	report[ACCTINT] = todToMicros(intTime);
+	report[ACCTIDLE] = todToMicros(idleTime);
+	report[ACCTKERNEL] = todToMicros(kernTime);
+}
+
+/***********************************************************************
+ *Function that handles a syscall 38 system call. The pseudo clock is
+ *only armed while a process waits for it, so any ticks that have come
+ *due since are caught up on first and the timer is reloaded for what
+ *matters next. The load statistics are then copied a word at a time.
+ *RETURNS: N/a
+ **********************************************************************/
+void getLoad(loadinfo_t *report){
+	
+	int i;
+	tod_t now;
+	int *source = (int *) &loadInfo;
+	int *target = (int *) report;
+	
+	/*If pseudo clock ticks went by unsampled...*/
+	TODCK(now);
+	if(now >= clockDeadline){
+		clockTick(now);
+		
+		/*Charge the time so far before the timer is reloaded*/
+		switchAccount(ACCTSYS);
+		setNextTimer(currentProcess);
+	}
+	
+	for(i = 0; i < (sizeof(loadinfo_t) / sizeof(int)); i++){
+		target[i] = source[i];
+	}
+}
+
+/***********************************************************************
+ *Function that handles a syscall 39 system call. It reports, and may
+ *reset, the latency histogram of the chosen target.
+ *RETURNS: SUCCESS or FAILURE if the target is not valid
+ **********************************************************************/
+int getLatency(int target, unsigned int *report, int reset){
+	
+	int i;
+	unsigned int *hist;
+	
+	if(target == TARGETSELF){
+		hist = currentProcess->p_latency;
+	}
+	else if((target == TARGETCHILD) && (currentProcess->p_child != NULL)){
+		hist = currentProcess->p_child->p_latency;
+	}
+	else if(target == TARGETSYSTEM){
+		hist = latencyHist;
+	}
+	else{
+		return FAILURE;
+	}
+	
+	for(i = 0; i < LATBUCKETS; i++){
+		report[i] = hist[i];
+		if(reset){
+			hist[i] = 0;
+		}
+	}
+	return SUCCESS;
+}
+
+/***********************************************************************
+ *Function that copies the state of the current process from the
+ *sysCallOld area into its pcb. It must be called before a syscall
+ *blocks the current process or takes the CPU away from it.
+ *RETURNS: N/a
+ **********************************************************************/
+void saveState(){
+	
+	moveState((state_t *) SYSCALLOLDADDR, &(currentProcess->p_s));
+}
+
+/***********************************************************************
+ *Function that performs the LDST instruction to load the given state
+ *of the current process into the processor.
  *RETURNS: N/a
  **********************************************************************/
-void headBackHome(){
+void headBackHome(state_t *state){
+	
+	/*The process is charged user time again*/
+	switchAccount(ACCTUSER);
 	
 	/*Load the current process*/
-	LDST(&(currentProcess->p_s));
+	LDST(state);
 
 }
 
@@ -562,7 +1006,7 @@ void nukeItTilItPukes(pcb_PTR parent){
 	
 	/*If the process is on the ready queue...*/
 	else if(parent->p_semAdd == NULL){
-		outProcQ(&(readyQueue), parent);
+		outReady(parent);
 	}
 	
 	else{
@@ -583,6 +1027,9 @@ void nukeItTilItPukes(pcb_PTR parent){
 		}
 	}
 	
+	/*Give back any real time utilization*/
+	leaveRealTime(parent);
+	
 	/*Free the process block and decrement process count*/
 	freePcb(parent);
 	processCount--;
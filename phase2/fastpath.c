@@ -0,0 +1,84 @@
+/***********************************************************************
+* FASTPATH.C
+* 
+* This file contains the syscall entry point of the JAEOS operating
+* system. P and V are by far the most frequent syscalls and most of them
+* neither block nor wake anyone, so the entry point handles those two
+* cases itself in a few instructions, straight from the sysCallOld area
+* and without touching the stack, and loads the caller back. Everything
+* else, a P that must block, a V with a waiter, any other syscall or any
+* call from user mode, is passed to sysCallHandler() untouched.
+* 
+* The few instructions of a fast P or V are left in the caller's user
+* time rather than charged as system time.
+*
+* Written by Jake Wagner
+* Last Updated: 11-1-16
+***********************************************************************/
+
+#include "../h/const.h"
+#include "../h/types.h"
+
+#include "../e/exceptions.e"
+#include "../e/fastpath.e"
+
+/***********************Global Definitions*****************************/
+
+/*No Global Definitions*/
+
+/*Turns a constant from const.h into an assembler operand*/
+#define ASMSTR(X)	#X
+#define ASMVAL(X)	ASMSTR(X)
+
+/*************************Main Functions*******************************/
+
+/***********************************************************************
+ *Function that is the new area entry point for every syscall. It does
+ *an uncontended P or V from system mode itself and passes every other
+ *syscall to sysCallHandler() with the sysCallOld area unchanged.
+ *RETURNS: N/a
+ **********************************************************************/
+__asm__(
+	"	.text\n"
+	"	.align	2\n"
+	"	.global	sysCallEntry\n"
+	"	.type	sysCallEntry, %function\n"
+	"sysCallEntry:\n"
+	"	ldr		r0, =" ASMVAL(SYSCALLOLDADDR) "\n"
+	
+	/*Only system mode may use the nucleus services*/
+	"	ldr		r1, [r0, #" ASMVAL(STATECPSR) "]\n"
+	"	and		r1, r1, #" ASMVAL(SYSTEMMODE) "\n"
+	"	cmp		r1, #" ASMVAL(SYSTEMMODE) "\n"
+	"	bne		sysCallHandler\n"
+	
+	"	ldr		r1, [r0, #" ASMVAL(STATEA1) "]\n"
+	"	ldr		r2, [r0, #" ASMVAL(STATEA2) "]\n"
+	"	cmp		r1, #" ASMVAL(VERHOGEN) "\n"
+	"	beq		1f\n"
+	"	cmp		r1, #" ASMVAL(PASSEREN) "\n"
+	"	bne		sysCallHandler\n"
+	
+	/*A P that would block is left to the handler*/
+	"	ldr		r3, [r2]\n"
+	"	subs	r3, r3, #1\n"
+	"	blt		sysCallHandler\n"
+	"	str		r3, [r2]\n"
+	"	b		2f\n"
+	
+	/*So is a V that would wake a waiter*/
+	"1:\n"
+	"	ldr		r3, [r2]\n"
+	"	adds	r3, r3, #1\n"
+	"	ble		sysCallHandler\n"
+	"	str		r3, [r2]\n"
+	
+	/*Step over the syscall and load the caller back*/
+	"2:\n"
+	"	ldr		r1, [r0, #" ASMVAL(STATEPC) "]\n"
+	"	add		r1, r1, #8\n"
+	"	str		r1, [r0, #" ASMVAL(STATEPC) "]\n"
+	"	b		LDST\n"
+	"	.ltorg\n"
+	"	.size	sysCallEntry, .-sysCallEntry\n"
+);
@@ -21,6 +21,7 @@
 #include "../e/scheduler.e"
 #include "../e/exceptions.e"
 #include "../e/interrupts.e"
+#include "../e/fastpath.e"
 
 #include "/usr/include/uarm/libuarm.h"
 
@@ -29,12 +30,11 @@
 int processCount;
 int softBlockCount;
 pcb_PTR currentProcess;
-pcb_PTR readyQueue;
-cpu_t startTOD;
+pcb_PTR readyQueue[READYQUEUES];
+tod_t startTOD;
 int semaphoreArray[MAXSEMA]; 
-int devStatus[MAXSEMA];
 int intTimerFlag;
-cpu_t timeLeft;
+tod_t clockDeadline;
 
 extern void test();
 
@@ -65,9 +65,14 @@ int main(){
 	/*Initialize array of semaphores to 0*/
 	for (i = 0; i < MAXSEMA; i++){
 		semaphoreArray[i] = 0;
-		devStatus[i] = 0;
 	}
 	
+	/*Clear the pseudo clock tick histogram*/
+	for (i = 0; i < JITTERBUCKETS; i++){
+		tickPeriods[i] = 0;
+	}
+	skippedTicks = 0;
+	
 	/*Populate the four new areas in low memory
 	 *	Set the stack pointer to last page of physical
 	 *	Set the pc to address of handler
@@ -77,7 +82,14 @@ int main(){
 	 */
 	statePtr = (state_t *) SYSCALLNEWADDR;
 	STST(statePtr);
-	statePtr->s_pc = (memaddr) sysCallHandler;		
+	
+	/*Uncontended P and V operations are finished by the fast path*/
+	if(FASTSYSCALL){
+		statePtr->s_pc = (memaddr) sysCallEntry;
+	}
+	else{
+		statePtr->s_pc = (memaddr) sysCallHandler;
+	}
 	statePtr->s_sp = bus->ramtop;
 	statePtr->s_cpsr = ALLOFF | IRQDISABLED | 
 								FIQDISABLED | SYSTEMMODE;
@@ -111,8 +123,10 @@ int main(){
 	processCount = 0;
 	softBlockCount = 0;
 	currentProcess = NULL;
-	startTOD = 0;
-	readyQueue = mkEmptyProcQ();
+	initReady();
+	initAccounts();
+	initLoad();
+	initInterrupts();
 	
 	/*Allocate a starting process*/
 	start = allocPcb();
@@ -130,14 +144,16 @@ int main(){
 	start->p_s.s_cpsr = ALLOFF | SYSTEMMODE;
 	
 	/*Start the interval timer and set pseudo clock timer*/
-	timeLeft = INTERVALTIME;
+	TODCK(lastTick);
+	clockDeadline = lastTick + USTOTOD(INTERVALTIME);
 	intTimerFlag = FALSE;
-	setTIMER(QUANTUM);
+	setTIMER((unsigned int) USTOTOD(QUANTUM));
 	 
 	/*Increment the number of current processes*/
 	processCount++;
 	/*Insert the new process onto the ready queue*/
-	insertProcQ(&(readyQueue), start);
+	start->p_quantumLeft = quantumOf(start);
+	makeReady(start);
 	
 	/*Call to the scheduler*/
 	getNewJob();
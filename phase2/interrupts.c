@@ -9,7 +9,10 @@
 * An interrupt can be caused by the interval timer going off or devices
 * requiring acknowlegment. When the interval timer goes off, it can
 * either be a process' quantum ending or the psuedo clock timer going
-* off.
+* off. The line to handle is looked up in a table built from a
+* configurable line order, each line has its handler in a table, and the
+* devices on a line are handled in turn starting after the one handled
+* last. How long each device waited to be acknowledged is counted.
 * 
 * There are five devices that are supported: disk, tape, network, 
 * printer and terminal devices. All devices except for the two clocks 
@@ -17,15 +20,27 @@
 * device semaphore and unblocking a waiting process.
 * 
 * The same happens for terminal devices except that there is only one
-* device for read and write and two semaphores, one for each case. Here,
-* writing takes precedence over reading. In every case, the device is
-* acknowledged and its status is stored in the return value. 
+* device for read and write and two semaphores, one for each case. When
+* both have finished, both are handled, writing first. In every case,
+* the device is acknowledged and its status is stored in the return
+* value, or, if no process is waiting yet, queued on the device's status
+* ring for the WAITFORIO that comes for it, so completions that arrive
+* ahead of their waiters each keep their own status. Every device that
+* has finished is handled in the same entry to the handler, so a burst
+* of completions costs one state save and one scheduling decision rather
+* than one of each per device.
 * 
-* When an interrupt occurs, the current TOD is stored and the elapsed
-* time that the current process has been running is stored to the
-* the processes time sheet since the interrupt may not be occuring on
-* behalf of that process. It also subtracts the elapsed time from the 
-* time left to the next pseudo clock interrupt.
+* When an interrupt occurs, the time the current process has been
+* running is charged to it, or the time the processor waited to the idle
+* time, since the interrupt may not be occuring on behalf of that
+* process. The time spent handling the interrupt is charged to the
+* nucleus's interrupt time rather than to any process and when the
+* process resumes the interval timer is reloaded with what is left of
+* its quantum, so I/O interrupts neither cut a quantum short nor stretch
+* it. The pseudo clock keeps its own deadline in TOD time and is due
+* whenever the TOD has passed it. Each deadline is one interval after
+* the one before, so late ticks do not make the pseudo clock drift, and
+* a histogram of the periods between ticks shows how much they jitter.
 *
 * Written by Jake Wagner
 * Last Updated: 11-1-16
@@ -40,295 +55,563 @@
 #include "../e/scheduler.e"
 #include "../e/interrupts.e"
 #include "../e/initial.e"
+#include "../e/memops.e"
 
 #include "/usr/include/uarm/libuarm.h"
 
 /***********************Global Definitions*****************************/
 
-/*No Global Definitions*/
+/*The TOD of the last pseudo clock tick*/
+tod_t lastTick;
 
-/*************************Main Functions*******************************/
+/*The histogram of the periods between pseudo clock ticks*/
+unsigned int tickPeriods[JITTERBUCKETS];
+
+/*The number of ticks that went by without being handled on time*/
+unsigned int skippedTicks;
+
+/*The number of acknowledgements of each device, their total and their
+ *longest delay since the device was first seen waiting, in TOD ticks*/
+unsigned int ackCount[DEVICECNT];
+tod_t ackTotal[DEVICECNT];
+tod_t ackMax[DEVICECNT];
+
+/*The number of completions lost because a status ring was full*/
+unsigned int statusOverruns;
+
+/*The completions of each device semaphore waiting for a WAITFORIO*/
+HIDDEN statring_t statusRing[DEVSEMS];
+
+/*The most important line of each set of pending lines*/
+HIDDEN int firstLine[LINESETS];
+
+/*The device of each line that was handled last*/
+HIDDEN int lastDevice[DEVINTNUM];
+
+/*The devices of each line already seen waiting and since when*/
+HIDDEN unsigned int seenDevices[DEVINTNUM];
+HIDDEN tod_t seenTOD[DEVICECNT];
+
+/*************************Helper Functions*****************************/
 
 /***********************************************************************
- *Function that handles interrupts. It handles the interrupts caused by
- *the psuedo-clock, disk, tape, network, printer and terminal
- *devices. Terminal interrupts are passed down to a different function
- *while all others are handled here. The handler acknowledges each
- *interrupt and either returns to the current job or gets a new job.
+ *Function that moves the pseudo clock deadline on by whole intervals
+ *from the previous deadline rather than from now, so a late tick does
+ *not push back the ones after it. If more than one interval went by,
+ *the missed ticks are caught up all at once. The period since the last
+ *tick is added to the tick period histogram, which is the only place
+ *the tick divides.
+ *RETURNS: the number of ticks that were due
+ **********************************************************************/
+HIDDEN int nextTick(tod_t now){
+	
+	int ticks = 0;
+	tod_t offset;
+	tod_t interval = USTOTOD(INTERVALTIME);
+	
+	/*Catch up on every deadline that has gone by*/
+	do{
+		clockDeadline = clockDeadline + interval;
+		ticks++;
+	}while(clockDeadline <= now);
+	
+	/*Only a single tick says anything about the period*/
+	if(ticks == 1){
+		offset = (now - lastTick) - interval +
+					USTOTOD((JITTERBUCKETS / 2) << JITTERSHIFT);
+		if(offset < 0){
+			offset = 0;
+		}
+		if(offset >= USTOTOD(JITTERBUCKETS << JITTERSHIFT)){
+			offset = USTOTOD(JITTERBUCKETS << JITTERSHIFT) - 1;
+		}
+		tickPeriods[(unsigned int) offset / 
+					(unsigned int) USTOTOD(1 << JITTERSHIFT)]++;
+	}
+	else{
+		skippedTicks = skippedTicks + (ticks - 1);
+	}
+	
+	lastTick = now;
+	return ticks;
+}
+
+/***********************************************************************
+ *Function that handles the pseudo clock ticks that have come due. Every
+ *process waiting for the clock is made ready, each tick counts down to
+ *the next priority boost and the load is sampled once for all of them.
  *RETURNS: N/a
  **********************************************************************/
-void interruptHandler(){
+void clockTick(tod_t now){
+	
+	pcb_PTR process;
+	int ticks = nextTick(now);
+	
+	/*Unblock the first process*/
+	process = removeBlocked(&(semaphoreArray[CLCKTIMER]));
+	
+	/*While there is still a process to remove...*/
+	while(process != NULL){
 		
-	/*Local Variable Declarations*/
+		process->p_semAdd = NULL;
+		softBlockCount--;
+		
+		/*Add it to the ready queue*/
+		makeReady(process);
+		
+		/*Remove the next process*/
+		process = removeBlocked(&(semaphoreArray[CLCKTIMER]));
+	}
+	
+	/*Set the seamphore to zero*/
+	semaphoreArray[CLCKTIMER] = 0;
+	
+	/*The ticks that were not taken on time are replayed into the load
+	 *averages by the one sample*/
+	sampleLoad(now, ticks);
+	
+	/*Count down to the next priority boost*/
+	while(ticks > 0){
+		agePriorities();
+		ticks--;
+	}
+}
+
+/***********************************************************************
+ *Function that handles an interval timer interrupt, which is either the
+ *pseudo clock tick coming due or the end of the current job's quantum
+ *or of the wait for a real time release.
+ *RETURNS: N/a
+ **********************************************************************/
+HIDDEN void handleTimer(int lineNum){
+	
+	tod_t now;
+	
+	TODCK(now);
+			
+	/*If the pseudo clock tick is due...*/ 
+	if(intTimerFlag || (now >= clockDeadline)){
+		clockTick(now);
+		
+		/*Start the new periods of real time jobs that are due*/
+		edfRelease();
+		return;
+	}
+	
+	/*If it was a release and the quantum is not used up...*/
+	if((currentProcess != NULL) && (currentProcess->p_period == 0)
+						&& (currentProcess->p_quantumLeft > 0)){
+		edfRelease();
+		return;
+	}
+	
+	/*It was a process's quantum ending, so if there was a process
+	 *running...*/
+	if(currentProcess != NULL){
+	
+		/*Put the process back according to its class, a new job is
+		 *picked on the way out*/
+		quantumExpired(currentProcess);
+		currentProcess = NULL;
+	}
+}
+
+/***********************************************************************
+ *Function that counts an acknowledgement of the given device and how
+ *long the device had been seen waiting for it.
+ *RETURNS: N/a
+ **********************************************************************/
+HIDDEN void recordAck(int deviceIndex){
+	
+	tod_t now;
+	tod_t delay;
+	int line = deviceIndex / DEVPERINT;
+	
+	TODCK(now);
+	delay = now - seenTOD[deviceIndex];
+	
+	ackCount[deviceIndex]++;
+	ackTotal[deviceIndex] = ackTotal[deviceIndex] + delay;
+	if(delay > ackMax[deviceIndex]){
+		ackMax[deviceIndex] = delay;
+	}
+	
+	/*It is stamped again the next time it is seen waiting*/
+	seenDevices[line] = seenDevices[line] & 
+							~(DEVICEONE << (deviceIndex % DEVPERINT));
+}
+
+/***********************************************************************
+ *Function that keeps the status of a completion that no process was
+ *waiting for at the back of the device semaphore's status ring. If the
+ *ring is full, the oldest status is lost.
+ *RETURNS: N/a
+ **********************************************************************/
+HIDDEN void pushStatus(int semDev, unsigned int status){
+	
+	statring_t *ring = &(statusRing[semDev]);
+	
+	if(ring->r_count == STATUSSLOTS){
+		ring->r_head = (ring->r_head + 1) & (STATUSSLOTS - 1);
+		ring->r_count--;
+		statusOverruns++;
+	}
+	
+	ring->r_status[(ring->r_head + ring->r_count) & (STATUSSLOTS - 1)] = 
+																status;
+	ring->r_count++;
+}
+
+/***********************************************************************
+ *Function that handles an interrupt from a disk, tape, network or
+ *printer device. It performs a V operation on the device semaphore,
+ *hands the device status to the waiting process and acknowledges the
+ *interrupt.
+ *RETURNS: N/a
+ **********************************************************************/
+HIDDEN void handleDevice(int lineNum){
+	
 	int devNum;
-	int lineNum;
 	int deviceIndex;
-	cpu_t elapsedTime;
 	device_t* dev;
-	pcb_PTR process;
-	unsigned int currentStatus;
-	state_t* oldInt = (state_t *) INTERRUPTOLDADDR;
+	pcb_PTR process = NULL;
 	devregarea_t* devReg = (devregarea_t *) DEVREGAREAADDR;
-	int pendingDevice = oldInt->s_CP15_Cause >> 24;
 	
-	/*Decrement pc to the instruction that was executing*/
-	oldInt->s_pc = oldInt->s_pc - 4;
+	/*Get the device number*/
+	devNum = getDeviceNumber(lineNum);
+	if(devNum < 0){
+		return;
+	}
 	
-	/*If there was a process running...*/
-	if(currentProcess != NULL){
-		cpu_t stopTOD;
-		
-		/*Store ending TOD*/
-		STCK(stopTOD);
-		
-		/*Store elapsed time*/
-		elapsedTime = stopTOD - startTOD;
-		currentProcess->p_time = currentProcess->p_time + elapsedTime;
-		timeLeft = timeLeft - elapsedTime;
+	/*Get the index of the device*/
+	deviceIndex = (DEVPERINT * (lineNum - DISKINT)) + devNum;
+	
+	/*Get the device generating the interrupt*/
+	dev = (device_t *) (devReg->devregbase + (deviceIndex * DEVREGSIZE));
+	
+	/*Increment semaphore address*/
+	semaphoreArray[deviceIndex] = semaphoreArray[deviceIndex] + 1;
+	
+	if(semaphoreArray[deviceIndex] <= 0){
 		
-		/*Move the old state into the current process*/
-		moveState(oldInt, &(currentProcess->p_s));
+		/*Unblock the next process*/
+		process = removeBlocked(&(semaphoreArray[deviceIndex]));
 	}
+	
+	if(process != NULL){
+		process->p_semAdd = NULL;
 		
-	/*If the interrupt was an interval timer interrupt...*/
-	if((pendingDevice & LINETWO) == LINETWO){
-				
-		/*If it was the interval timer...*/ 
-		if(intTimerFlag || (timeLeft < 0)){
-			
-			/*Unblock the first process*/
-			process = removeBlocked(&(semaphoreArray[CLCKTIMER]));
-			
-			/*While there is still a process to remove...*/
-			while(process != NULL){
-				
-				process->p_semAdd = NULL;
-				softBlockCount--;
-				
-				/*Add it to the ready queue*/
-				insertProcQ(&(readyQueue), process);
-				
-				/*Remove the next process*/
-				process = removeBlocked(&(semaphoreArray[CLCKTIMER]));
-			}
-			
-			/*Set the seamphore to zero*/
-			semaphoreArray[CLCKTIMER] = 0;
-
-			/*Reload the interval timer*/
-			setTIMER(QUANTUM);
-			timeLeft = INTERVALTIME;
-			intTimerFlag = FALSE;
-					
-			/*Leave the interrupt*/
-			returnFromInterrupt();
-			
-		}
-		/*It was a process's quantum ending*/
-		else{
+		/*Set status of interrupt for the waiting process*/
+		process->p_s.s_a1 = dev->d_status;		
+		softBlockCount--;
 		
-			/*If there was a process running...*/
-			if(currentProcess != NULL){
-			
-				/*Add the process back to the ready queue*/
-				insertProcQ(&(readyQueue), currentProcess);
-				currentProcess = NULL;
-			}
-			
-			setTIMER(QUANTUM);
-			
-			/*Get a new job*/
-			getNewJob();
-		}
+		/*Add it to the ready queue*/
+		wakeReady(process);
 	}
 	else{
-		/*If the interrupt was a disk device interrupt...*/
-		if((pendingDevice & LINETHREE) == LINETHREE){
-			
-			/*Get the device number*/
-			devNum = getDeviceNumber(DISKINT);
-			lineNum = DISKINT;
-		}
-		
-		/*If the interrupt was a tape device interrupt...*/
-		else if((pendingDevice & LINEFOUR) == LINEFOUR){
-			
-			/*Get the device number*/
-			devNum = getDeviceNumber(TAPEINT);
-			lineNum = TAPEINT;
-		}
+		/*Keep the status for the process that waits for it*/
+		pushStatus(deviceIndex, dev->d_status);
+	}
+	
+	/*Acknowledge the command*/
+	dev->d_command = ACK;
+	recordAck(deviceIndex);
+}
+
+/***********************************************************************
+ *Function that handles an interrupt on the terminal line by passing
+ *the terminal to handleTerminal().
+ *RETURNS: N/a
+ **********************************************************************/
+HIDDEN void handleTermLine(int lineNum){
+	
+	int devNum = getDeviceNumber(lineNum);
+	
+	if(devNum >= 0){
+		handleTerminal(devNum);
+		recordAck((DEVPERINT * (TERMINT - DISKINT)) + devNum);
+	}
+}
+
+/***********************************************************************
+ *Function that checks whether a terminal sub-device has finished a
+ *command and is waiting to be acknowledged.
+ *RETURNS: TRUE if it has, FALSE if it is ready or still busy
+ **********************************************************************/
+HIDDEN int termDone(unsigned int status){
+	
+	status = status & DEVSTATMASK;
+	
+	return ((status != READY) && (status != BUSY) && 
+										(status != UNINSTALLED));
+}
+
+/***********************************************************************
+ *Function that performs a V operation on the semaphore of a terminal
+ *sub-device, hands the status to the waiting process and acknowledges
+ *the sub-device.
+ *RETURNS: N/a
+ **********************************************************************/
+HIDDEN void termAck(int semAdd, unsigned int status, 
+												unsigned int *command){
+	
+	pcb_PTR process = NULL;
+	
+	/*Increment semaphore address*/
+	semaphoreArray[semAdd] = semaphoreArray[semAdd] + 1;
+	
+	if(semaphoreArray[semAdd] <= 0){	
 		
-		/*If the interrupt was a network device interrupt...*/
-		else if((pendingDevice & LINEFIVE) == LINEFIVE){
-			
-			/*Get the device number*/
-			devNum = getDeviceNumber(NETWINT);
-			lineNum = NETWINT;
-		}
+		/*Unblock the process*/
+		process = removeBlocked(&(semaphoreArray[semAdd]));
+	}
+	
+	if(process != NULL){
+		process->p_semAdd = NULL;
+		process->p_s.s_a1 = status;
+		softBlockCount--;
 		
-		/*If the interrupt was a printer device interrupt...*/
-		else if((pendingDevice & LINESIX) == LINESIX){
-			
-			/*Get the device number*/
-			devNum = getDeviceNumber(PRNTINT);
-			lineNum = PRNTINT;
-		}
+		/*Add it to the ready queue*/
+		wakeReady(process);
+	}
+	else{
+		/*Keep the status for the process that waits for it*/
+		pushStatus(semAdd, status);
+	}
+	
+	/*Acknowledge the command*/
+	*command = ACK;
+}
+
+/***********************************************************************
+ *Function that finds the device lines with a device still waiting to
+ *be acknowledged by reading their interrupt bit maps. A device seen
+ *waiting for the first time is stamped with the given TOD for its
+ *acknowledgement delay.
+ *RETURNS: the lines in the same bits as the cause register
+ **********************************************************************/
+HIDDEN unsigned int devicesPending(tod_t now){
+	
+	int lineNum;
+	int line;
+	unsigned int devices;
+	unsigned int newDevices;
+	unsigned int lines = 0;
+	unsigned int *devBitMap = (unsigned int *) INTBITMAPADDR;
+	
+	for(lineNum = DISKINT; lineNum <= TERMINT; lineNum++){
+		line = lineNum - DISKINT;
+		devices = *devBitMap & DEVICEMASK;
 		
-		/*If the interrupt was a terminal device interrupt...*/
-		else if((pendingDevice & LINESEVEN) == LINESEVEN){
+		if(devices != 0){
+			lines = lines | (1 << lineNum);
 			
-			/*Get the device number*/
-			devNum = getDeviceNumber(TERMINT);
-			lineNum = TERMINT;
-		}
-		
-		/*If the interrupt was a terminal interrupt...*/
-		if(lineNum == TERMINT){
-					
-			/*Pass it to a helper*/
-			handleTerminal(devNum);
+			/*Stamp the devices that were not waiting before*/
+			newDevices = devices & ~(seenDevices[line]);
+			while(newDevices != 0){
+				seenTOD[(line * DEVPERINT) + lowestBit(newDevices)] = now;
+				newDevices = newDevices & (newDevices - 1);
+			}
+			seenDevices[line] = seenDevices[line] | devices;
 		}
+		devBitMap++;
+	}
+	return lines;
+}
+
+/*The handler of each interrupt line, lines 0 and 1 are never handled*/
+HIDDEN void (* const lineHandler[INTLINES])(int lineNum) = {
+	NULL, NULL, handleTimer, handleDevice, handleDevice, handleDevice,
+	handleDevice, handleTermLine
+};
+
+/*************************Main Functions*******************************/
+
+/***********************************************************************
+ *Function that handles interrupts. It handles the interrupts caused by
+ *the psuedo-clock, disk, tape, network, printer and terminal devices.
+ *The most important pending line is looked up in a table indexed by the
+ *set of pending lines and handled by the line's entry in the handler
+ *table, so the decode costs the same whichever line fired. Lines are
+ *handled until the interrupt bit maps show no device left to
+ *acknowledge, and only then does the handler either return to the
+ *current job or get a new job.
+ *RETURNS: N/a
+ **********************************************************************/
+void interruptHandler(){
 		
-		/*Get the modified line number*/
-		lineNum = lineNum - DISKINT;
-		
-		/*Get the index of the device*/
-		deviceIndex = (DEVPERINT * lineNum) + devNum;
+	/*Local Variable Declarations*/
+	int lineNum;
+	tod_t now;
+	unsigned int pendingLines;
+	state_t* oldInt = (state_t *) INTERRUPTOLDADDR;
+	
+	/*Decrement pc to the instruction that was executing*/
+	oldInt->s_pc = oldInt->s_pc - 4;
+	
+	/*Charge whoever was running, or the idle time, and charge the
+	 *handler to the interrupt time*/
+	switchAccount(ACCTINT);
+	
+	/*If there was a process running...*/
+	if(currentProcess != NULL){
 		
-		/*Get the device generating the interrupt*/
-		dev = (device_t *) (devReg->devregbase + (deviceIndex * DEVREGSIZE));
+		/*Move the old state into the current process*/
+		moveState(oldInt, &(currentProcess->p_s));
+	}
+	
+	/*The timer is only pending in the cause register, the devices
+	 *are looked up in the bit maps*/
+	TODCK(now);
+	pendingLines = ((oldInt->s_CP15_Cause >> LINESHIFT) & LINETWO) | 
+													devicesPending(now);
+	
+	/*Find the most important line with an interrupt pending*/
+	lineNum = firstLine[pendingLines];
+	
+	/*Until no device is left waiting to be acknowledged...*/
+	while(lineNum >= 0){
+		lineHandler[lineNum](lineNum);
 		
-		/*Increment semaphore address*/
-		semaphoreArray[deviceIndex] = semaphoreArray[deviceIndex] + 1;
+		/*The timer is handled once, the devices are looked up again
+		 *since more of them may have finished in the meantime*/
+		TODCK(now);
+		pendingLines = (pendingLines & LINETWO & ~(1 << lineNum)) | 
+													devicesPending(now);
+		lineNum = firstLine[pendingLines];
+	}
+	
+	/*Make one scheduling decision for all of them*/
+	returnFromInterrupt();
+}
+
+/*************************Helper Functions*****************************/
+
+/***********************************************************************
+ *Function that initializes the interrupt line order and the device
+ *acknowledgement counters. The lines are handled in the order of the
+ *hex digits of LINEORDER, and every set of pending lines is looked up
+ *once here so the handler never has to search for its first line.
+ *RETURNS: N/a
+ **********************************************************************/
+void initInterrupts(){
+	
+	int i;
+	int lines;
+	int lineNum;
+	
+	for(lines = 0; lines < LINESETS; lines++){
+		firstLine[lines] = -1;
 		
-		if(semaphoreArray[deviceIndex] <= 0){
-			
-			/*Unblock the next process*/
-			process = removeBlocked(&(semaphoreArray[deviceIndex]));
-			if(process != NULL){
-				process->p_semAdd = NULL;
-				
-				/*Set status of interrupt for the waiting process*/
-				process->p_s.s_a1 = dev->d_status;		
-				softBlockCount--;
-				
-				/*Add it to the ready queue*/
-				insertProcQ(&(readyQueue), process);
-			}
-			else{
-				/*Set status of interrupt for the current process*/
-				devStatus[deviceIndex] = dev->d_status;
+		/*Take the first line in the order that is pending*/
+		for(i = LINEORDERLEN - 1; (i >= 0) && (firstLine[lines] < 0); i--){
+			lineNum = LINEDIGIT(i);
+			if((lines & (1 << lineNum)) != 0){
+				firstLine[lines] = lineNum;
 			}
 		}
-		
-		/*Acknowledge the command*/
-		dev->d_command = ACK;
-		
-		/*Leave the interrupt*/
-		returnFromInterrupt();
 	}
 	
+	for(i = 0; i < DEVINTNUM; i++){
+		lastDevice[i] = DEVPERINT - 1;
+		seenDevices[i] = 0;
+	}
+	
+	for(i = 0; i < DEVSEMS; i++){
+		statusRing[i].r_head = 0;
+		statusRing[i].r_count = 0;
+	}
+	statusOverruns = 0;
+	
+	for(i = 0; i < DEVICECNT; i++){
+		ackCount[i] = 0;
+		ackTotal[i] = 0;
+		ackMax[i] = 0;
+		seenTOD[i] = 0;
+	}
 }
 
-/*************************Helper Functions*****************************/
+/***********************************************************************
+ *Function that takes the oldest status from the device semaphore's
+ *status ring for a WAITFORIO whose completion came in first. The ring
+ *is only empty if its statuses were lost to an overrun.
+ *RETURNS: the status of the completion or NOSTATUS if there is none
+ **********************************************************************/
+unsigned int popStatus(int semDev){
+	
+	unsigned int status;
+	statring_t *ring = &(statusRing[semDev]);
+	
+	if(ring->r_count == 0){
+		return NOSTATUS;
+	}
+	
+	status = ring->r_status[ring->r_head];
+	ring->r_head = (ring->r_head + 1) & (STATUSSLOTS - 1);
+	ring->r_count--;
+	
+	return status;
+}
 
 /***********************************************************************
  *Function that gets the device number of the device generating an
- *interrupt. It examines the bit map and determines which bit is on and
- *the device generating the interrupt.
+ *interrupt. The line's bit map is rotated to start just after the
+ *device handled last, so the devices on a line take turns rather than
+ *the lowest numbered one always going first, and the lowest bit that
+ *is on is found with a bit scan.
  *RETURNS: The number of the device on the line generating the interrupt
+ *or -1 if no device on the line is
  **********************************************************************/
 int getDeviceNumber(int lineNumber){
 	
-	/*Local Variable Declarations*/
-	unsigned int *devBitMap;
-	unsigned int currentDevice = DEVICEONE;
-	int devNum = 0;
-	int found = FALSE;
-	
-	/*Get the modified line number*/
-	lineNumber = lineNumber - 3;
+	int devNum;
+	int line = lineNumber - DISKINT;
+	int start = (lastDevice[line] + 1) % DEVPERINT;
 	
 	/*Examine the bit map*/
-	devBitMap = (unsigned int *) (INTBITMAPADDR + (lineNumber * DEVREGLEN));
+	unsigned int devices = *((unsigned int *) 
+						(INTBITMAPADDR + (line * DEVREGLEN))) & DEVICEMASK;
 	
-	/*While the interrupting device hasn't been found...*/
-	while(!found){
-		
-		/*If the bit is on...*/
-		if((currentDevice & *devBitMap) == currentDevice){
-			found = TRUE;
-		}
-		
-		/*Move to the next bit*/
-		else{
-			currentDevice = currentDevice << 1;
-			devNum++;
-		}
+	/*Rotate it so the device after the last one is bit zero*/
+	devices = ((devices >> start) | (devices << (DEVPERINT - start))) & 
+																DEVICEMASK;
+	
+	devNum = lowestBit(devices);
+	if(devNum < 0){
+		return -1;
 	}
 	
-	/*Return the number of the device on the line*/
+	devNum = (devNum + start) % DEVPERINT;
+	lastDevice[line] = devNum;
+	
 	return devNum;
 }
 
 /***********************************************************************
- *Function that handles terminal interrupts. It checks first to see if
- *the terminal was transmitting. Then it performs a V operation on the
- *semaphore for that device and acknowledges the interrupt.
+ *Function that handles terminal interrupts. A terminal is one device
+ *with two sub-devices, and both can have finished at once, so each of
+ *them that has is handled, the transmitter first.
  *RETURNS: N/a
  **********************************************************************/
 void handleTerminal(int devNumber){	
 	
 	/*Local Variable Declarations*/
-	pcb_PTR process;
 	int semAdd = (TERMINT-DISKINT)*DEVPERINT + devNumber;
-	int receive = TRUE;
 	devregarea_t* devReg = (devregarea_t *) DEVREGAREAADDR;
 	device_t* dev = (device_t *) (devReg->devregbase + (semAdd * DEVREGSIZE));
 	
-	/*If a character was transmitted and is not ready...*/
-	if((dev->t_transm_status & 0x0F) != READY){
+	/*If a character was transmitted...*/
+	if(termDone(dev->t_transm_status)){
 		
-		/*Increase the semaphore device number by 8*/
-		semAdd = semAdd + DEVPERINT;
-		receive = FALSE;
+		/*The write semaphore is 8 past the read semaphore*/
+		termAck(semAdd + DEVPERINT, dev->t_transm_status, 
+										&(dev->t_transm_command));
 	}
 	
-	/*Increment semaphore address*/
-	semaphoreArray[semAdd] = semaphoreArray[semAdd] + 1;
-	
-	if(semaphoreArray[semAdd] <= 0){	
-		
-		/*Unblock the process*/
-		process = removeBlocked(&(semaphoreArray[semAdd]));
-		if(process != NULL){
-			process->p_semAdd = NULL;
-			
-			/*If the device was receiving...*/
-			if(receive){
-
-				/*Acknowledge the read*/
-				process->p_s.s_a1 = dev->t_recv_status;
-				dev->t_recv_command = ACK;
-			}
-			
-			/*The device was transmitting*/
-			else{
-
-				/*Acknowledge the transmit*/
-				process->p_s.s_a1 = dev->t_transm_status;
-				dev->t_transm_command = ACK;
-			}
-			
-			softBlockCount--;
-			
-			/*Add it to the ready queue*/
-			insertProcQ(&(readyQueue), process);
-		}
+	/*If a character was received...*/
+	if(termDone(dev->t_recv_status)){
+		termAck(semAdd, dev->t_recv_status, &(dev->t_recv_command));
 	}
-	
-	/*Leave the interrupt*/
-	returnFromInterrupt();
 }
 
 /***********************************************************************
@@ -341,8 +624,17 @@ void returnFromInterrupt(){
 	
 	/*If processor wasn't waiting...*/
 	if(currentProcess != NULL){
-		/*Store start TOD*/
-		STCK(startTOD);
+		
+		/*If a more urgent real time job is ready, switch to it*/
+		if(shouldPreempt()){
+			preempt();
+		}
+		
+		/*The process is charged user time again*/
+		switchAccount(ACCTUSER);
+		
+		/*Reload the timer with what is left of the job's quantum*/
+		setNextTimer(currentProcess);
 		
 		/*Continue where it left off*/
 		LDST(&(currentProcess->p_s));
@@ -0,0 +1,132 @@
+/***********************************************************************
+* MEMOPS.C
+* 
+* This file contains the block memory operations of the JAEOS operating
+* system: copying a processor state, and copying, zeroing and comparing
+* a page of memory. They sit under every context switch, syscall, pass
+* up, disk transfer and tape block, so they are written with the ARM
+* multiple register load and store instructions, which move up to eight
+* words in one instruction instead of one word at a time.
+* 
+* A page is moved in bursts of BURSTWORDS words through the registers
+* r3 to r10, which are declared clobbered so the compiler saves the ones
+* it needs around the burst loop.
+*
+* Written by Jake Wagner
+* Last Updated: 11-1-16
+***********************************************************************/
+
+#include "../h/const.h"
+#include "../h/types.h"
+
+#include "../e/memops.e"
+
+/***********************Global Definitions*****************************/
+
+/*No Global Definitions*/
+
+/*************************Main Functions*******************************/
+
+/***********************************************************************
+ *Function that copies the source state into a target state. The 22
+ *registers are moved in bursts of eight, eight and six words.
+ *RETURNS: N/a
+ **********************************************************************/
+void moveState(state_t* source, state_t* target){
+	
+	int *src = (int *) source;
+	int *dst = (int *) target;
+	
+	__asm__ volatile(
+		"ldmia %0!, {r3-r10}\n\t"
+		"stmia %1!, {r3-r10}\n\t"
+		"ldmia %0!, {r3-r10}\n\t"
+		"stmia %1!, {r3-r10}\n\t"
+		"ldmia %0!, {r3-r8}\n\t"
+		"stmia %1!, {r3-r8}\n\t"
+		: "+r" (src), "+r" (dst)
+		:
+		: "r3", "r4", "r5", "r6", "r7", "r8", "r9", "r10", "memory");
+}
+
+/***********************************************************************
+ *Function that copies one page of memory from a source memory address
+ *to a destination memory address. Both must be word aligned.
+ *RETURNS: N/a
+ **********************************************************************/
+void copyPage(int* source, int* target){
+	
+	int bursts = PAGESIZE / (BURSTWORDS * WORDLEN);
+	
+	__asm__ volatile(
+		"1:\n\t"
+		"ldmia %0!, {r3-r10}\n\t"
+		"stmia %1!, {r3-r10}\n\t"
+		"subs %2, %2, #1\n\t"
+		"bne 1b\n\t"
+		: "+r" (source), "+r" (target), "+r" (bursts)
+		:
+		: "r3", "r4", "r5", "r6", "r7", "r8", "r9", "r10", 
+														"cc", "memory");
+}
+
+/***********************************************************************
+ *Function that fills one page of memory at a destination memory address
+ *with zeros. It must be word aligned.
+ *RETURNS: N/a
+ **********************************************************************/
+void zeroPage(int* target){
+	
+	int bursts = PAGESIZE / (BURSTWORDS * WORDLEN);
+	
+	__asm__ volatile(
+		"mov r3, #0\n\t"
+		"mov r4, #0\n\t"
+		"mov r5, #0\n\t"
+		"mov r6, #0\n\t"
+		"mov r7, #0\n\t"
+		"mov r8, #0\n\t"
+		"mov r9, #0\n\t"
+		"mov r10, #0\n\t"
+		"1:\n\t"
+		"stmia %0!, {r3-r10}\n\t"
+		"subs %1, %1, #1\n\t"
+		"bne 1b\n\t"
+		: "+r" (target), "+r" (bursts)
+		:
+		: "r3", "r4", "r5", "r6", "r7", "r8", "r9", "r10", 
+														"cc", "memory");
+}
+
+/***********************************************************************
+ *Function that compares two pages of memory. Each side is loaded four
+ *words at a time and the comparison stops at the first burst that
+ *differs. Both must be word aligned.
+ *RETURNS: TRUE if the pages hold the same words, FALSE otherwise
+ **********************************************************************/
+int comparePage(int* first, int* second){
+	
+	int same;
+	int bursts = PAGESIZE / ((BURSTWORDS / 2) * WORDLEN);
+	
+	__asm__ volatile(
+		"1:\n\t"
+		"ldmia %1!, {r3-r6}\n\t"
+		"ldmia %2!, {r7-r10}\n\t"
+		"cmp r3, r7\n\t"
+		"cmpeq r4, r8\n\t"
+		"cmpeq r5, r9\n\t"
+		"cmpeq r6, r10\n\t"
+		"bne 2f\n\t"
+		"subs %3, %3, #1\n\t"
+		"bne 1b\n\t"
+		"2:\n\t"
+		"moveq %0, #1\n\t"
+		"movne %0, #0\n\t"
+		: "=r" (same), "+r" (first), "+r" (second), "+r" (bursts)
+		:
+		: "r3", "r4", "r5", "r6", "r7", "r8", "r9", "r10", 
+														"cc", "memory");
+	
+	return same;
+}
@@ -7,8 +7,49 @@
 * processor state to the state of that process. This begins process 
 * execution.
 * 
-* It also contains a method that copies the 22 words in one state area
-* in memory into another state area for easier state changing.
+* The ready queue is a multi-level feedback queue for each static
+* priority. Jobs are always taken from the most important priority with
+* a ready job, and within it from the highest non-empty level, each
+* level down getting twice the quantum of the one above it. A bitmap of
+* the non-empty queues finds the next job without scanning them.
+* 
+* Within a queue, jobs are picked by hierarchical stride scheduling over
+* the process tree. Each process holds tickets that split its parent's
+* share of the CPU between it and its siblings, and a pass value that
+* grows with the CPU time its whole subtree uses divided by its tickets.
+* Of two ready jobs, the one whose subtree has the lower pass where their
+* ancestries meet runs first, so a process that spawns many children
+* cannot take more than its subtree's share from its siblings. Each
+* queue is kept in that order as jobs are made ready, so the next job is
+* always at its head.
+* 
+* Real time jobs that declared a period and a budget form a separate
+* earliest deadline first class that always runs ahead of the normal
+* one. A job is only admitted if the total utilization of the class
+* stays under a limit, it is never given more of the interval timer
+* than is left of its budget and once the budget is used up it is held
+* back until its next period. Any job still unfinished when its
+* deadline passes counts as a deadline miss.
+* 
+* The interval timer is only loaded with the events that matter: the end
+* of the quantum if some other job is waiting for the CPU, the pseudo
+* clock tick if some job is waiting for it and the release of a held
+* back real time job. A job running alone is not interrupted and an idle
+* processor only wakes for a device or for one of those events. A job
+* that uses its whole quantum moves down a level, a job that blocks on a
+* semaphore or on I/O moves up a level and every few pseudo clock ticks
+* every job is boosted back to the top level so long running jobs are
+* never starved.
+* 
+* A job woken by a device can optionally be moved ahead of the others,
+* either to run next or to take the CPU straight away, once the job it
+* interrupted has used enough of its quantum. That keeps the devices
+* busy when they are shared with jobs that only compute.
+* 
+* CPU time is charged to one account at a time: the current process's
+* user or system time, or the nucleus's interrupt, idle or own time.
+* Each switch from one account to the next charges the time since the
+* last one, so every TOD tick ends up in exactly one account.
 *
 * Written by Jake Wagner
 * Last Updated: 4-20-16
@@ -39,7 +80,69 @@ void debugB(int b){
 
 /***********************Global Definitions*****************************/
 
-/*No Global Definitions*/
+/*The number of priority boosts so far*/
+int boostEpoch;
+
+/*The pseudo clock ticks left until the next priority boost*/
+HIDDEN int boostTicks;
+
+/*Bit i is on when ready queue i is not empty*/
+HIDDEN unsigned int readyMap;
+
+/*The bit numbers of the 32 isolated bits, indexed by de Bruijn hash*/
+HIDDEN const int bitTable[32] = {
+	0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+	31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+};
+
+/*The ready real time jobs and the ones waiting out a used up budget*/
+HIDDEN pcb_PTR edfQueue;
+HIDDEN pcb_PTR throttleQueue;
+
+/*The utilization of the admitted real time jobs, in thousandths*/
+HIDDEN int edfUtil;
+
+/*Real time statistics*/
+int deadlineMisses;
+int budgetOverruns;
+
+/*Whether the interval timer will end the current job's quantum*/
+HIDDEN int quantumArmed;
+
+/*The account the time since startTOD is being charged to*/
+HIDDEN int account;
+
+/*The time the nucleus spent handling interrupts, waiting for one with
+ *nothing to run and working with no current process to charge*/
+tod_t intTime;
+tod_t idleTime;
+tod_t kernTime;
+
+/*The load statistics sampled at each pseudo clock tick, with the TOD
+ *and idle time of the last sample*/
+loadinfo_t loadInfo;
+HIDDEN tod_t loadTOD;
+HIDDEN tod_t loadIdle;
+
+/*The number of jobs ready or running at the last sample*/
+HIDDEN unsigned int loadRunning;
+
+/*The decay factors of the load averages*/
+HIDDEN const unsigned int loadExp[LOADAVGS] = {
+	LOADEXP1, LOADEXP5, LOADEXP15
+};
+
+/*The ready to run latency histogram of the whole system*/
+unsigned int latencyHist[LATBUCKETS];
+
+/*The job woken from I/O that goes ahead of its queue and whether it
+ *should take the CPU from the current job*/
+HIDDEN pcb_PTR wakeNext;
+HIDDEN int wakePreempt;
+
+#if READYQUEUES > 32
+#error "The ready bitmap holds at most 32 queues"
+#endif
 
 /*************************Main Functions*******************************/
 
@@ -54,9 +157,12 @@ void getNewJob(){
 	
 	/*Declare a new job*/
 	pcb_PTR newJob = NULL;
+	
+	/*Start the new periods of any real time jobs that are due*/
+	edfRelease();
 
 	/*Get a new job from the ready queue*/
-	newJob = removeProcQ(&(readyQueue));
+	newJob = removeReady();
 	
 	/*If there were no jobs on the ready queue...*/
 	if(newJob == NULL){
@@ -68,17 +174,21 @@ void getNewJob(){
 			HALT();
 		}	
 		else if(processCount > 0){
-			/*If there are no processes blocked by I/O...*/
-			if(softBlockCount == 0){	
+			/*If there are no processes blocked by I/O or waiting
+			 *out their budget...*/
+			if((softBlockCount == 0) && emptyProcQ(throttleQueue)){	
 										
 				PANIC();
 			}
 
 			/*If there are processes blocked by I/0...*/
-			if(softBlockCount > 0){
+			else{
 				
-				setTIMER(timeLeft);
-				intTimerFlag = TRUE;
+				/*The wait is idle time*/
+				switchAccount(ACCTIDLE);
+				
+				/*Only wake for the events someone is waiting on*/
+				setNextTimer(NULL);
 				
 				/*Enable interrupts in the processor*/
 				setSTATUS(getSTATUS() & ALLINTENABLED);
@@ -96,48 +206,1079 @@ void getNewJob(){
 /*************************Helper Functions*****************************/
 
 /***********************************************************************
- *Function that takes a new job, sets it to the current process, checks
- *to see if a the timer should be the end of a quantum or the interval
- *timer, then proceeds to perform a load state operation.
+ *Function that takes a new job, sets it to the current process, loads
+ *the timer with the next event that matters to it, then proceeds to
+ *perform a load state operation.
  *RETURNS: N/a
  **********************************************************************/
 void processJob(pcb_PTR newJob){
 		
-	/*Set the current process to the new job*/
+	/*The time it took to get here is the nucleus's own, not the new
+	 *job's, and none of it comes out of the new job's quantum*/
+	if((account == ACCTUSER) || (account == ACCTSYS)){
+		account = ACCTKERNEL;
+	}
+	quantumArmed = FALSE;
+	
+	/*Set the current process to the new job, its time starts now*/
 	currentProcess = newJob;
+	switchAccount(ACCTUSER);
+	
+	/*Record how long it waited on the ready queue*/
+	recordLatency(newJob, startTOD - newJob->p_readyTOD);
+	
+	/*Set the timer for the new job*/
+	setNextTimer(newJob);
+	
+	/*Load the new job*/
+	LDST(&(newJob->p_s));
+	
+}
+
+/***********************************************************************
+ *Function that adds the time a job waited between being made ready and
+ *being dispatched to its own and the system's latency histograms. The
+ *buckets double in width, so the bucket is found by comparing against
+ *each bound rather than by dividing.
+ *RETURNS: N/a
+ **********************************************************************/
+void recordLatency(pcb_PTR p, tod_t delay){
+	
+	int i = 0;
+	tod_t bound = USTOTOD(LATBASE);
+	
+	while((i < (LATBUCKETS - 1)) && (delay >= bound)){
+		bound = bound << 1;
+		i++;
+	}
+	
+	p->p_latency[i]++;
+	latencyHist[i]++;
+}
+
+/***********************************************************************
+ *Function that finds the ready queue of the given priority and level.
+ *RETURNS: the index of the ready queue
+ **********************************************************************/
+HIDDEN int queueOf(int prio, int level){
+	
+	return ((prio * MLFQLEVELS) + level);
+}
+
+/***********************************************************************
+ *Function that finds how deep the given process is in the process tree.
+ *RETURNS: the number of ancestors of the process
+ **********************************************************************/
+HIDDEN int depthOf(pcb_PTR p){
+	
+	int depth = 0;
+	
+	while(p->p_prnt != NULL){
+		p = p->p_prnt;
+		depth++;
+	}
+	return depth;
+}
+
+/***********************************************************************
+ *Function that decides whether the first job should run before the
+ *second by comparing the pass values of their subtrees where their
+ *ancestries meet. A job never goes before its own ancestor or
+ *descendant, those keep their queue order.
+ *RETURNS: TRUE if the first job goes first, FALSE otherwise
+ **********************************************************************/
+HIDDEN int strideBefore(pcb_PTR a, pcb_PTR b){
+	
+	int depthA = depthOf(a);
+	int depthB = depthOf(b);
+	
+	/*Climb to the same depth*/
+	while(depthA > depthB){
+		a = a->p_prnt;
+		depthA--;
+	}
+	while(depthB > depthA){
+		b = b->p_prnt;
+		depthB--;
+	}
+	
+	/*If one was the ancestor of the other...*/
+	if(a == b){
+		return FALSE;
+	}
+	
+	/*Climb until the two subtrees are siblings*/
+	while(a->p_prnt != b->p_prnt){
+		a = a->p_prnt;
+		b = b->p_prnt;
+	}
+	
+	/*Compare so that the pass values may wrap around*/
+	return (((int) (a->p_pass - b->p_pass)) < 0);
+}
+
+/***********************************************************************
+ *Function that inserts a job into the given ready queue in pass order,
+ *behind every job that goes before it or ties with it, so the head of
+ *the queue is the job whose subtree was furthest behind its share when
+ *it was made ready. New jobs mostly belong near the tail, so the walk
+ *starts there.
+ *RETURNS: N/a
+ **********************************************************************/
+HIDDEN void insertByPass(pcb_PTR *tp, pcb_PTR p){
+	
+	pcb_PTR q = *tp;
+	
+	/*Walk back past every job the new one goes before*/
+	while((q != NULL) && strideBefore(p, q)){
+		if(q == headProcQ(*tp)){
+			q = NULL;
+		}
+		else{
+			q = q->p_prev;
+		}
+	}
+	
+	insertAfterProcQ(tp, q, p);
+}
+
+/***********************************************************************
+ *Function that starts the next period of a real time job whose deadline
+ *has passed. Whole periods that went by are skipped.
+ *RETURNS: N/a
+ **********************************************************************/
+HIDDEN void newPeriod(pcb_PTR p, tod_t now){
+	
+	do{
+		p->p_deadline = p->p_deadline + p->p_period;
+	}while(p->p_deadline <= now);
+	p->p_used = 0;
+}
+
+/***********************************************************************
+ *Function that finds the ready real time job with the earliest deadline.
+ *RETURNS: the job or NULL if no real time job is ready
+ **********************************************************************/
+HIDDEN pcb_PTR earliestDeadline(){
+	
+	pcb_PTR best;
+	pcb_PTR p;
+	
+	if(emptyProcQ(edfQueue)){
+		return NULL;
+	}
+	
+	best = edfQueue->p_next;
+	for(p = best->p_next; p != edfQueue->p_next; p = p->p_next){
+		if(p->p_deadline < best->p_deadline){
+			best = p;
+		}
+	}
+	return best;
+}
+
+/***********************************************************************
+ *Function that computes the utilization of a real time job with the
+ *given period and budget, rounded up so admission control errs on the
+ *safe side.
+ *RETURNS: the utilization in thousandths
+ **********************************************************************/
+HIDDEN int utilOf(cpu_t period, cpu_t budget){
+	
+	return ((budget + (period / SHARESCALE) - 1) / (period / SHARESCALE));
+}
+
+/***********************************************************************
+ *Function that empties every level of the ready queue and starts the
+ *countdown to the first priority boost.
+ *RETURNS: N/a
+ **********************************************************************/
+void initReady(){
+	
+	int i;
+	
+	for(i = 0; i < READYQUEUES; i++){
+		readyQueue[i] = mkEmptyProcQ();
+	}
+	
+	readyMap = 0;
+	edfQueue = mkEmptyProcQ();
+	throttleQueue = mkEmptyProcQ();
+	edfUtil = 0;
+	deadlineMisses = 0;
+	budgetOverruns = 0;
+	boostEpoch = 0;
+	boostTicks = BOOSTTICKS;
+	wakeNext = NULL;
+	wakePreempt = FALSE;
+	
+	for(i = 0; i < LATBUCKETS; i++){
+		latencyHist[i] = 0;
+	}
+}
+
+/***********************************************************************
+ *Function that adds a job to its level of the ready queue in pass order.
+ *A job that has not been seen since the last priority boost goes back
+ *to the top level. The time it is made ready is stamped on it so the
+ *wait for the CPU can be measured. A real time job goes on the real
+ *time queue and starts a new period if its deadline passed while it was
+ *blocked.
+ *RETURNS: N/a
+ **********************************************************************/
+void makeReady(pcb_PTR p){
+	
+	tod_t now;
+	
+	/*Start timing how long it waits to run*/
+	TODCK(now);
+	p->p_readyTOD = now;
+	
+	/*If the job is real time...*/
+	if(p->p_period > 0){
+		
+		if(now >= p->p_deadline){
+			newPeriod(p, now);
+		}
+		
+		insertProcQ(&(edfQueue), p);
+		return;
+	}
+	
+	/*If the job missed a boost while it was blocked or running...*/
+	if(p->p_epoch != boostEpoch){
+		p->p_level = 0;
+		p->p_epoch = boostEpoch;
+	}
+	
+	insertByPass(&(readyQueue[queueOf(p->p_prio, p->p_level)]), p);
+	readyMap = readyMap | (1 << queueOf(p->p_prio, p->p_level));
+}
+
+/***********************************************************************
+ *Function that removes the real time job with the earliest deadline
+ *or, if there is none, the job at the head of the most important
+ *non-empty ready queue, which is the lowest bit of the ready bitmap.
+ *RETURNS: the job or NULL if the ready queue is empty
+ **********************************************************************/
+pcb_PTR removeReady(){
+	
+	int i;
+	pcb_PTR p = wakeNext;
+	
+	wakeNext = NULL;
+	wakePreempt = FALSE;
+	
+	/*If a real time job is ready...*/
+	if(!emptyProcQ(edfQueue)){
+		return outProcQ(&(edfQueue), earliestDeadline());
+	}
+	
+	/*If every queue is empty...*/
+	if(readyMap == 0){
+		return NULL;
+	}
+	
+	i = lowestBit(readyMap);
+	
+	/*If a job woken from I/O goes first and nothing more important is
+	 *ready...*/
+	if((p != NULL) && (i >= queueOf(p->p_prio, 0))){
+		return outReady(p);
+	}
+	
+	p = removeProcQ(&(readyQueue[i]));
+	
+	if(emptyProcQ(readyQueue[i])){
+		readyMap = readyMap & ~(1 << i);
+	}
+	return p;
+}
+
+/***********************************************************************
+ *Function that removes the given job from its level of the ready queue.
+ *RETURNS: the job or NULL if it was not on the ready queue
+ **********************************************************************/
+pcb_PTR outReady(pcb_PTR p){
+	
+	int i = queueOf(p->p_prio, p->p_level);
+	pcb_PTR retPcb;
+	
+	if(p == wakeNext){
+		wakeNext = NULL;
+		wakePreempt = FALSE;
+	}
+	
+	/*If the job is real time...*/
+	if(p->p_period > 0){
+		
+		if(p->p_throttled){
+			p->p_throttled = FALSE;
+			return outProcQ(&(throttleQueue), p);
+		}
+		return outProcQ(&(edfQueue), p);
+	}
+	
+	retPcb = outProcQ(&(readyQueue[i]), p);
+	
+	if(emptyProcQ(readyQueue[i])){
+		readyMap = readyMap & ~(1 << i);
+	}
+	return retPcb;
+}
+
+/***********************************************************************
+ *Function that moves a job that used its whole quantum down a level.
+ *RETURNS: N/a
+ **********************************************************************/
+void demote(pcb_PTR p){
+	
+	if(p->p_level < (MLFQLEVELS - 1)){
+		p->p_level++;
+	}
+}
+
+/***********************************************************************
+ *Function that moves a job that blocked before its quantum ended up a
+ *level.
+ *RETURNS: N/a
+ **********************************************************************/
+void promote(pcb_PTR p){
+	
+	if(p->p_level > 0){
+		p->p_level--;
+	}
+}
+
+/***********************************************************************
+ *Function that counts down pseudo clock ticks to the next priority
+ *boost. On a boost every ready job is moved to the top level, blocked
+ *and running jobs are moved up the next time they are made ready.
+ *RETURNS: N/a
+ **********************************************************************/
+void agePriorities(){
+	
+	int i, prio;
+	pcb_PTR p;
+	tod_t ready;
+	
+	boostTicks--;
+	if(boostTicks > 0){
+		return;
+	}
+	
+	boostTicks = BOOSTTICKS;
+	boostEpoch++;
+	
+	/*Move every lower level of each priority to its top level, keeping
+	 *the time each job has waited so far*/
+	for(prio = 0; prio < NUMPRIO; prio++){
+		for(i = queueOf(prio, 1); i < queueOf(prio + 1, 0); i++){
+			
+			p = removeProcQ(&(readyQueue[i]));
+			while(p != NULL){
+				ready = p->p_readyTOD;
+				makeReady(p);
+				p->p_readyTOD = ready;
+				p = removeProcQ(&(readyQueue[i]));
+			}
+			readyMap = readyMap & ~(1 << i);
+		}
+	}
+}
+
+/***********************************************************************
+ *Function that computes the quantum of a job from its level, or from
+ *what is left of its budget if it is a real time job.
+ *RETURNS: the quantum in TOD ticks
+ **********************************************************************/
+tod_t quantumOf(pcb_PTR p){
+	
+	/*If the job is real time...*/
+	if(p->p_period > 0){
+		
+		if((p->p_budget - p->p_used) < USTOTOD(EDFMINSLICE)){
+			return USTOTOD(EDFMINSLICE);
+		}
+		return (p->p_budget - p->p_used);
+	}
+	
+	return (USTOTOD(QUANTUM) << p->p_level);
+}
+
+/***********************************************************************
+ *Function that finds the lowest bit that is on in the given bitmap. The
+ *ARM7TDMI has no count leading zeros instruction, so the lowest bit is
+ *isolated and hashed into a table by a de Bruijn multiply instead.
+ *RETURNS: the bit number or -1 if no bit is on
+ **********************************************************************/
+int lowestBit(unsigned int map){
+	
+	if(map == 0){
+		return -1;
+	}
+	
+	return bitTable[((map & (~map + 1)) * 0x077CB531U) >> 27];
+}
+
+/***********************************************************************
+ *Function that charges CPU time to the given process. The time is added
+ *to the process's own time and to the subtree time and pass value of
+ *the process and of each of its ancestors. The pass value goes up by
+ *the stride worked out when the tickets were set, so no division is
+ *needed here.
+ *RETURNS: N/a
+ **********************************************************************/
+void chargeTime(pcb_PTR p, tod_t elapsed){
+	
+	p->p_time = p->p_time + elapsed;
+	
+	/*Only time spent competing for the CPU comes out of the quantum*/
+	if(quantumArmed && (p == currentProcess)){
+		p->p_quantumLeft = p->p_quantumLeft - elapsed;
+	}
+	
+	/*If the job is real time, it comes out of its budget*/
+	if(p->p_period > 0){
+		p->p_used = p->p_used + elapsed;
+	}
+	
+	/*Charge every subtree the process is in*/
+	while(p != NULL){
+		p->p_treeTime = p->p_treeTime + elapsed;
+		p->p_pass = p->p_pass + 
+				(unsigned int) ((elapsed * p->p_stride) >> STRIDESHIFT);
+		p = p->p_prnt;
+	}
+}
+
+/***********************************************************************
+ *Function that starts the CPU time accounts with nothing charged. Until
+ *the first job runs the time is the nucleus's own.
+ *RETURNS: N/a
+ **********************************************************************/
+void initAccounts(){
+	
+	intTime = 0;
+	idleTime = 0;
+	kernTime = 0;
+	account = ACCTSYS;
+	TODCK(startTOD);
+}
+
+/***********************************************************************
+ *Function that charges the time since startTOD to the account it was
+ *being charged to and starts charging the given account from now on.
+ *User and system time go to the current process, and system time with
+ *no current process goes to the nucleus's own time.
+ *RETURNS: N/a
+ **********************************************************************/
+void switchAccount(int next){
+	
+	tod_t now;
+	tod_t elapsed;
+	
+	TODCK(now);
+	elapsed = now - startTOD;
+	
+	switch(account){
+		
+		case ACCTUSER:
+		case ACCTSYS:
+			if(currentProcess != NULL){
+				chargeTime(currentProcess, elapsed);
+				if(account == ACCTSYS){
+					currentProcess->p_sysTime = 
+								currentProcess->p_sysTime + elapsed;
+				}
+			}
+			else{
+				kernTime = kernTime + elapsed;
+			}
+			break;
+			
+		case ACCTKERNEL:
+			kernTime = kernTime + elapsed;
+			break;
+			
+		case ACCTINT:
+			intTime = intTime + elapsed;
+			break;
+			
+		case ACCTIDLE:
+			idleTime = idleTime + elapsed;
+			break;
+	}
+	
+	startTOD = now;
+	account = next;
+}
+
+/***********************************************************************
+ *Function that counts the jobs on the given ready queue.
+ *RETURNS: the number of jobs
+ **********************************************************************/
+HIDDEN int queueLength(pcb_PTR tp){
+	
+	int length = 0;
+	pcb_PTR p;
+	
+	if(emptyProcQ(tp)){
+		return 0;
+	}
+	
+	p = tp;
+	do{
+		p = p->p_next;
+		length++;
+	}while(p != tp);
+	
+	return length;
+}
+
+/***********************************************************************
+ *Function that clears the load statistics.
+ *RETURNS: N/a
+ **********************************************************************/
+void initLoad(){
+	
+	int i;
+	
+	for(i = 0; i < LOADAVGS; i++){
+		loadInfo.l_avg[i] = 0;
+	}
+	for(i = 0; i < LOADHISTORY; i++){
+		loadInfo.l_procs[i] = 0;
+		loadInfo.l_blocked[i] = 0;
+	}
+	loadInfo.l_ready = 0;
+	loadInfo.l_idle = 0;
+	loadInfo.l_next = 0;
+	loadRunning = 0;
+	
+	TODCK(loadTOD);
+	loadIdle = idleTime;
+}
+
+/***********************************************************************
+ *Function that raises a load average decay factor to the given power,
+ *in fixed point, by repeated squaring.
+ *RETURNS: the decay factor of that many ticks
+ **********************************************************************/
+HIDDEN unsigned int loadDecay(unsigned int e, int ticks){
+	
+	unsigned int decay = LOADFIXED1;
+	
+	while(ticks > 0){
+		if(ticks & 1){
+			decay = (unsigned int) 
+				(((unsigned long long) decay * e) >> LOADSHIFT);
+		}
+		e = (unsigned int) (((unsigned long long) e * e) >> LOADSHIFT);
+		ticks = ticks >> 1;
+	}
+	return decay;
+}
+
+/***********************************************************************
+ *Function that takes a sample of the load at the last of the given
+ *number of pseudo clock ticks. The share of the time since the last
+ *sample that was idle is worked out first. The ticks before the last
+ *one went by unsampled while nothing waited for the clock, so each
+ *load average is decayed over all of them at once towards the count of
+ *the last sample for the time the processor was busy and towards none
+ *for the time it was idle. The number of jobs ready or running now is
+ *then decayed in for the last tick and the process and blocked counts
+ *go into the history ring once.
+ *RETURNS: N/a
+ **********************************************************************/
+void sampleLoad(tod_t now, int ticks){
+	
+	int i;
+	unsigned int running;
+	unsigned int missed;
+	unsigned int decay;
+	unsigned long long avg;
+	tod_t span;
+	tod_t idle;
+	
+	/*Ticks caught up on at once share one idle sample*/
+	if(now > loadTOD){
+		span = now - loadTOD;
+		idle = idleTime - loadIdle;
+		
+		/*Shift both down until a single word division will do*/
+		while(span >= (1 << 24)){
+			span = span >> 1;
+			idle = idle >> 1;
+		}
+		loadInfo.l_idle = ((unsigned int) idle * 100) / (unsigned int) span;
+		
+		loadTOD = now;
+		loadIdle = idleTime;
+	}
+	
+	/*Replay the missed ticks with the load they most likely had*/
+	if(ticks > 1){
+		missed = ((loadRunning << LOADSHIFT) / 100) * 
+										(100 - loadInfo.l_idle);
+		
+		/*avg = avg * e^n + missed * (1 - e^n), in fixed point*/
+		for(i = 0; i < LOADAVGS; i++){
+			decay = loadDecay(loadExp[i], ticks - 1);
+			avg = ((unsigned long long) loadInfo.l_avg[i] * decay) +
+				((unsigned long long) missed * (LOADFIXED1 - decay));
+			loadInfo.l_avg[i] = (unsigned int) (avg >> LOADSHIFT);
+		}
+	}
+	
+	loadInfo.l_ready = queueLength(edfQueue);
+	for(i = 0; i < READYQUEUES; i++){
+		loadInfo.l_ready = loadInfo.l_ready + queueLength(readyQueue[i]);
+	}
+	
+	running = loadInfo.l_ready;
+	if(currentProcess != NULL){
+		running++;
+	}
 	
-	/*Store starting TOD*/
-	STCK(startTOD);
+	/*avg = avg * e + running * (1 - e), in fixed point*/
+	for(i = 0; i < LOADAVGS; i++){
+		avg = ((unsigned long long) loadInfo.l_avg[i] * loadExp[i]) +
+			((unsigned long long) (running << LOADSHIFT) * 
+											(LOADFIXED1 - loadExp[i]));
+		loadInfo.l_avg[i] = (unsigned int) (avg >> LOADSHIFT);
+	}
+	
+	loadInfo.l_procs[loadInfo.l_next] = processCount;
+	loadInfo.l_blocked[loadInfo.l_next] = softBlockCount;
+	loadInfo.l_next = (loadInfo.l_next + 1) & (LOADHISTORY - 1);
 	
-	if(timeLeft < 0) timeLeft = 0;
+	loadRunning = running;
+}
+
+/***********************************************************************
+ *Function that starts a new child's pass value at the lowest pass value
+ *of its siblings, so it neither owes for nor is owed the CPU time used
+ *before it existed.
+ *RETURNS: N/a
+ **********************************************************************/
+void joinSiblings(pcb_PTR p){
 	
-	/*If there is less than than one quantum left on the clock...*/
-	if(timeLeft < QUANTUM){			
+	pcb_PTR sib;
+	int found = FALSE;
+	
+	for(sib = p->p_prnt->p_child; sib != NULL; sib = sib->p_prevSib){
 		
-		/*Set the new job's timer to be the remaining interval time*/
-		setTIMER(timeLeft);
+		if((sib != p) && 
+			(!found || (((int) (sib->p_pass - p->p_pass)) < 0))){
+			p->p_pass = sib->p_pass;
+			found = TRUE;
+		}
+	}
+}
+
+/***********************************************************************
+ *Function that moves the given job into the real time class with the
+ *given period and budget in microseconds, which are kept in TOD ticks
+ *from then on. Its first deadline is one period from now.
+ *The job is only admitted if the total utilization of the class stays
+ *under its limit. A period of zero moves the job back to the normal
+ *class. The job must not be on any ready queue.
+ *RETURNS: SUCCESS or FAILURE if the job could not be admitted
+ **********************************************************************/
+int admitRealTime(pcb_PTR p, cpu_t period, cpu_t budget){
+	
+	int oldUtil = 0;
+	int newUtil;
+	tod_t now;
+	
+	/*If the job is leaving the real time class...*/
+	if(period == 0){
+		leaveRealTime(p);
+		return SUCCESS;
+	}
+	
+	/*If the period or budget make no sense...*/
+	if((period < EDFMINPERIOD) || (budget < EDFMINSLICE) || 
+													(budget > period)){
+		return FAILURE;
+	}
+	
+	/*A job that was admitted before gives back its old utilization*/
+	if(p->p_period > 0){
+		oldUtil = p->p_util;
+	}
+	newUtil = utilOf(period, budget);
+	
+	/*If the class would be overloaded...*/
+	if((edfUtil - oldUtil + newUtil) > EDFMAXUTIL){
+		return FAILURE;
+	}
+	
+	edfUtil = edfUtil - oldUtil + newUtil;
+	p->p_util = newUtil;
+	p->p_period = USTOTOD(period);
+	p->p_budget = USTOTOD(budget);
+	
+	TODCK(now);
+	p->p_deadline = now + p->p_period;
+	p->p_used = 0;
+	
+	return SUCCESS;
+}
+
+/***********************************************************************
+ *Function that moves the given job out of the real time class and gives
+ *back its utilization. The job must not be on any ready queue.
+ *RETURNS: N/a
+ **********************************************************************/
+void leaveRealTime(pcb_PTR p){
+	
+	if(p->p_period > 0){
+		edfUtil = edfUtil - p->p_util;
+	}
+	
+	p->p_period = 0;
+	p->p_budget = 0;
+	p->p_util = 0;
+	p->p_used = 0;
+	p->p_throttled = FALSE;
+}
+
+/***********************************************************************
+ *Function that starts the new period of every ready, running or held
+ *back real time job whose deadline has passed. Since those jobs had
+ *not finished their work, each one counts as a deadline miss. Held back
+ *jobs get their budget back and are made ready again.
+ *RETURNS: N/a
+ **********************************************************************/
+void edfRelease(){
+	
+	tod_t now;
+	pcb_PTR p;
+	int found = TRUE;
+	
+	TODCK(now);
+	
+	/*Ready jobs that missed*/
+	if(!emptyProcQ(edfQueue)){
+		p = edfQueue;
+		do{
+			p = p->p_next;
+			if(now >= p->p_deadline){
+				deadlineMisses++;
+				newPeriod(p, now);
+			}
+		} while(p != edfQueue);
+	}
+	
+	/*The running job*/
+	if((currentProcess != NULL) && (currentProcess->p_period > 0) && 
+							  (now >= currentProcess->p_deadline)){
+		deadlineMisses++;
+		newPeriod(currentProcess, now);
+	}
+	
+	/*Held back jobs*/
+	while(found){
+		found = FALSE;
+		
+		if(!emptyProcQ(throttleQueue)){
+			p = throttleQueue;
+			do{
+				p = p->p_next;
+				found = (now >= p->p_deadline);
+			} while(!found && (p != throttleQueue));
+		}
+		
+		if(found){
+			outProcQ(&(throttleQueue), p);
+			p->p_throttled = FALSE;
+			deadlineMisses++;
+			newPeriod(p, now);
+			p->p_readyTOD = now;
+			insertProcQ(&(edfQueue), p);
+		}
+	}
+}
+
+/***********************************************************************
+ *Function that finds how long until the first held back real time job
+ *gets its budget back.
+ *RETURNS: the time in TOD ticks or -1 if no job is held back
+ **********************************************************************/
+tod_t edfNextRelease(){
+	
+	tod_t now;
+	tod_t first;
+	pcb_PTR p;
+	
+	if(emptyProcQ(throttleQueue)){
+		return -1;
+	}
+	
+	first = throttleQueue->p_deadline;
+	for(p = throttleQueue->p_next; p != throttleQueue; p = p->p_next){
+		if(p->p_deadline < first){
+			first = p->p_deadline;
+		}
+	}
+	
+	TODCK(now);
+	if(first < now){
+		return 0;
+	}
+	return (first - now);
+}
+
+/***********************************************************************
+ *Function that puts back a job whose interval timer slice ran out. A
+ *normal job moves down a level. A real time job that used up its budget
+ *is held back until its next period, otherwise it is made ready again.
+ *RETURNS: N/a
+ **********************************************************************/
+void quantumExpired(pcb_PTR p){
+	
+	/*If the job is real time...*/
+	if(p->p_period > 0){
+		
+		/*If the budget is used up...*/
+		if((p->p_used + USTOTOD(EDFMINSLICE)) > p->p_budget){
+			budgetOverruns++;
+			p->p_throttled = TRUE;
+			insertProcQ(&(throttleQueue), p);
+		}
+		else{
+			makeReady(p);
+		}
+		return;
+	}
+	
+	/*It used its whole quantum, so move it down a queue*/
+	demote(p);
+	p->p_quantumLeft = quantumOf(p);
+	makeReady(p);
+}
+
+/***********************************************************************
+ *Function that checks whether a ready real time job should take the CPU
+ *from the current job, because the current job is not real time or has
+ *a later deadline, or whether a job woken from I/O should.
+ *RETURNS: TRUE if the current job should be preempted, FALSE otherwise
+ **********************************************************************/
+int shouldPreempt(){
+	
+	if(currentProcess == NULL){
+		return FALSE;
+	}
+	
+	/*If a job woken from I/O is to take the CPU...*/
+	if(wakePreempt){
+		return TRUE;
+	}
+	
+	if(emptyProcQ(edfQueue)){
+		return FALSE;
+	}
+	
+	if(currentProcess->p_period == 0){
+		return TRUE;
+	}
+	
+	return (earliestDeadline()->p_deadline < currentProcess->p_deadline);
+}
+
+/***********************************************************************
+ *Function that puts the current job back on the ready queue and gets a
+ *new job. The current job's time must already have been charged.
+ *RETURNS: N/a
+ **********************************************************************/
+void preempt(){
+	
+	makeReady(currentProcess);
+	currentProcess = NULL;
+	
+	getNewJob();
+}
+
+/***********************************************************************
+ *Function that switches the CPU straight from the current job to the
+ *given job, which has just been unblocked, and gives it what is left of
+ *the current job's quantum. The current job goes back on the ready
+ *queue with a whole quantum for its next turn. If either job is real
+ *time or the given job has a less important priority, it is only made
+ *ready. The current job's time must already have been charged.
+ *RETURNS: only if the given job was made ready instead
+ **********************************************************************/
+void handOff(pcb_PTR p){
+	
+	pcb_PTR caller = currentProcess;
+	
+	if((p->p_period > 0) || (caller->p_period > 0) ||
+									(p->p_prio > caller->p_prio)){
+		makeReady(p);
+		return;
+	}
+	
+	/*If the job missed a boost while it was blocked...*/
+	if(p->p_epoch != boostEpoch){
+		p->p_level = 0;
+		p->p_epoch = boostEpoch;
+	}
+	
+	/*It did not wait on the ready queue at all*/
+	p->p_readyTOD = startTOD;
+	
+	/*Donate the rest of the quantum*/
+	p->p_quantumLeft = caller->p_quantumLeft;
+	caller->p_quantumLeft = quantumOf(caller);
+	
+	makeReady(caller);
+	processJob(p);
+}
+
+/***********************************************************************
+ *Function that makes ready a job whose I/O has just completed. If the
+ *interrupted job has used more than WAKETHRESHOLD percent of its
+ *quantum, the woken job runs next under the WAKEHEAD policy and takes
+ *the CPU at once under the WAKEPREEMPT policy. Neither happens when
+ *either job is real time or the woken job has a less important
+ *priority.
+ *RETURNS: N/a
+ **********************************************************************/
+void wakeReady(pcb_PTR p){
+	
+	tod_t quantum;
+	
+	makeReady(p);
+	
+	if((WAKEPOLICY == WAKEQUEUE) || (currentProcess == NULL) || 
+			(p->p_period > 0) || (currentProcess->p_period > 0) ||
+			(p->p_prio > currentProcess->p_prio)){
+		return;
+	}
+	
+	/*If the interrupted job has not used enough of its quantum...*/
+	quantum = quantumOf(currentProcess);
+	if(((quantum - currentProcess->p_quantumLeft) * 100) <= 
+										(quantum * WAKETHRESHOLD)){
+		return;
+	}
+	
+	wakeNext = p;
+	wakePreempt = (WAKEPOLICY == WAKEPREEMPT);
+}
+
+/***********************************************************************
+ *Function that checks whether any job is waiting on a ready queue.
+ *RETURNS: TRUE if a job is ready, FALSE otherwise
+ **********************************************************************/
+HIDDEN int jobsWaiting(){
+	
+	return ((readyMap != 0) || !emptyProcQ(edfQueue));
+}
+
+/***********************************************************************
+ *Function that loads the interval timer with the first event that
+ *matters to the given job, or to the idle processor if there is no job.
+ *The quantum only matters if another job is waiting for the CPU or the
+ *job is on a real time budget, and only what is left of it is loaded.
+ *The pseudo clock tick only matters if a job is waiting for it. If
+ *nothing matters the timer is set as far out as it goes.
+ *RETURNS: N/a
+ **********************************************************************/
+void setNextTimer(pcb_PTR job){
+	
+	tod_t now;
+	tod_t tick;
+	tod_t slice = TIMERMAX;
+	tod_t release = edfNextRelease();
+	
+	intTimerFlag = FALSE;
+	quantumArmed = FALSE;
+	
+	/*Find how long it is to the pseudo clock deadline*/
+	TODCK(now);
+	tick = clockDeadline - now;
+	if(tick < 0){
+		tick = 0;
+	}
+	
+	/*If the job is on a budget...*/
+	if((job != NULL) && (job->p_period > 0)){
+		slice = quantumOf(job);
+		quantumArmed = TRUE;
+	}
+	/*If the job has to share the CPU...*/
+	else if((job != NULL) && jobsWaiting()){
+		slice = job->p_quantumLeft;
+		if(slice < 0){
+			slice = 0;
+		}
+		quantumArmed = TRUE;
+	}
+	
+	/*If a job is waiting for the pseudo clock...*/
+	if((semaphoreArray[CLCKTIMER] < 0) && (tick <= slice)){
+		slice = tick;
 		intTimerFlag = TRUE;
 	}
-	else{
-		/*Set the new job's timer to be a full quantum*/
-		setTIMER(QUANTUM);
+	
+	/*If a held back real time job is due first...*/
+	if((release >= 0) && (release < slice)){
+		slice = release;
+		intTimerFlag = FALSE;
 	}
 	
-	/*Load the new job*/
-	LDST(&(newJob->p_s));
+	/*A quantum low in the queues may be longer than the timer goes*/
+	if(slice > TIMERMAX){
+		slice = TIMERMAX;
+	}
 	
+	setTIMER((unsigned int) slice);
 }
 
 /***********************************************************************
- *Function that copies the source state into a target state.
+ *Function that starts the current job's quantum if it was running
+ *alone and another job has just been made ready.
  *RETURNS: N/a
  **********************************************************************/
-void moveState(state_t* source, state_t* target){
+void rearmTimer(){
+	
+	if((currentProcess == NULL) || quantumArmed || !jobsWaiting()){
+		return;
+	}
+	
+	/*Charge the time it ran alone, which is not taken from its quantum*/
+	switchAccount(account);
+	
+	setNextTimer(currentProcess);
+}
+
+/***********************************************************************
+ *Function that converts raw TOD ticks to microseconds for the syscalls
+ *that report time. The ARM7TDMI has no divide instruction, so it is a
+ *long division a bit at a time, which is only done at the syscall
+ *boundary and never while scheduling.
+ *RETURNS: the time in microseconds
+ **********************************************************************/
+cpu_t todToMicros(tod_t ticks){
 	
 	int i;
+	unsigned long long rem = 0;
+	unsigned long long quot = 0;
+	unsigned long long num = (unsigned long long) ticks;
+	unsigned int scale = * ((unsigned int *) TIMESCALEADDR);
 	
-	/*Copy the 22 registers*/
-	for(i = 0; i < STATEREGNUM; i++){
-		target->s_reg[i] = source->s_reg[i];
-	} 
+	for(i = 63; i >= 0; i--){
+		rem = (rem << 1) | ((num >> i) & 1);
+		quot = quot << 1;
+		
+		if(rem >= scale){
+			rem = rem - scale;
+			quot = quot | 1;
+		}
+	}
+	return (cpu_t) quot;
 }
@@ -0,0 +1,199 @@
+/***********************************************************************
+* HPT.C
+*
+* This file creates and maintains the Hashed Page Table for the kUseg2
+* segment of every user process in the JAEOS operating system.
+*
+* The hardware page table of a user process only holds a small number
+* of slots for the pages that are currently resident in the swap pool.
+* The Hashed Page Table describes every page a process has actually
+* touched, so the memory it uses grows with the number of pages in use
+* rather than with the size of the address space. Each virtual page
+* descriptor records the backing store block holding the page and the
+* swap pool frame it currently occupies.
+*
+* Descriptors are instantiated via an array and kept on a singly linked
+* linear free stack. Active descriptors are kept in singly linked
+* linear bucket chains selected by hashing the process ID and the page
+* number together.
+*
+* This interface has mutator methods to insert a descriptor for a page
+* and to remove every descriptor belonging to a process. It has an
+* accessor method to find the descriptor for a given page.
+*
+* Written by Jake Wagner
+* Last Updated: 11-1-16
+***********************************************************************/
+
+#include "../h/const.h"
+#include "../h/types.h"
+
+#include "../e/hpt.e"
+
+/***********************Global Definitions*****************************/
+
+/*The pointer to the head of the Virtual Page Descriptor Free List*/
+HIDDEN vpte_t *vpteFree_h;
+
+/*The heads of the Hashed Page Table bucket chains*/
+HIDDEN vpte_t *hptBucket[HPTBUCKETS];
+
+/*************************Helper Functions*****************************/
+
+/***********************************************************************
+ *Function that selects the bucket for the given process ID and page
+ *number. The bucket count is a power of two so no division is needed.
+ *RETURNS: the index of the bucket chain
+ **********************************************************************/
+HIDDEN int hashPage(int asid, unsigned int pageNo){
+	return (int)((pageNo ^ (pageNo >> 6) ^ (asid << 3))
+												  & (HPTBUCKETS - 1));
+}
+
+
+/****************Page Descriptor Free List Implementation**************/
+
+/***********************************************************************
+ *Function that adds a page descriptor that is no longer in use to the
+ *Virtual Page Descriptor Free List.
+ *RETURNS: N/a
+ **********************************************************************/
+HIDDEN void freeVpte(vpte_t *vpte){
+
+	/*Push it on the free stack*/
+	vpte->v_next = vpteFree_h;
+	vpteFree_h = vpte;
+}
+
+/***********************************************************************
+ *Function that removes a page descriptor from the Virtual Page
+ *Descriptor Free List and returns it.
+ *RETURNS: a pointer to a page descriptor or NULL if the free list is
+ *empty
+ **********************************************************************/
+HIDDEN vpte_t *allocVpte(){
+
+	vpte_t *retVpte = vpteFree_h;
+
+	/*If the free list is empty...*/
+	if(retVpte == NULL){
+		return NULL;
+	}
+
+	vpteFree_h = retVpte->v_next;
+
+	/*Wash the dishes*/
+	retVpte->v_next = NULL;
+	retVpte->v_asid = -1;
+	retVpte->v_pageNo = 0;
+	retVpte->v_block = -1;
+	retVpte->v_frame = -1;
+	retVpte->v_flags = 0;
+
+	return retVpte;
+}
+
+/***********************************************************************
+ *Function that initializes the Hashed Page Table and the Virtual Page
+ *Descriptor Free List.
+ *RETURNS: N/a
+ **********************************************************************/
+void initHPT(){
+
+	int i;
+	/*Create a static array of page descriptors*/
+	static vpte_t vpteTable[HPTSIZE];
+
+	vpteFree_h = NULL;
+
+	for(i = 0; i < HPTBUCKETS; i++){
+		hptBucket[i] = NULL;
+	}
+
+	for(i = 0; i < HPTSIZE; i++){
+		/*Add it to the Virtual Page Descriptor Free List*/
+		freeVpte(&(vpteTable[i]));
+	}
+}
+
+
+/********************Hashed Page Table Implementation******************/
+
+/***********************************************************************
+ *Function that finds the descriptor for the given page of the given
+ *process.
+ *RETURNS: a pointer to the page descriptor or NULL if the process has
+ *never touched the page
+ **********************************************************************/
+vpte_t *hptLookup(int asid, unsigned int pageNo){
+
+	vpte_t *current = hptBucket[hashPage(asid, pageNo)];
+
+	/*While there is still a node to look at...*/
+	while(current != NULL){
+		if((current->v_asid == asid) && (current->v_pageNo == pageNo)){
+			return current;
+		}
+		current = current->v_next;
+	}
+	return NULL;
+}
+
+/***********************************************************************
+ *Function that allocates a descriptor for the given page of the given
+ *process and weaves it into the front of its bucket chain.
+ *RETURNS: a pointer to the new page descriptor or NULL if there are no
+ *more descriptors available
+ **********************************************************************/
+vpte_t *hptInsert(int asid, unsigned int pageNo){
+
+	int bucket;
+	vpte_t *newVpte = allocVpte();
+
+	/*If one could not be allocated...*/
+	if(newVpte == NULL){
+		return NULL;
+	}
+
+	newVpte->v_asid = asid;
+	newVpte->v_pageNo = pageNo;
+
+	/*Weave it into the bucket chain*/
+	bucket = hashPage(asid, pageNo);
+	newVpte->v_next = hptBucket[bucket];
+	hptBucket[bucket] = newVpte;
+
+	return newVpte;
+}
+
+/***********************************************************************
+ *Function that removes every descriptor belonging to the given process
+ *and returns them to the free list.
+ *RETURNS: N/a
+ **********************************************************************/
+void hptRemoveProc(int asid){
+
+	int i;
+	vpte_t **link;
+	vpte_t *current;
+
+	/*For each bucket chain...*/
+	for(i = 0; i < HPTBUCKETS; i++){
+
+		link = &(hptBucket[i]);
+		while(*link != NULL){
+			current = *link;
+
+			/*If the descriptor belongs to the process...*/
+			if(current->v_asid == asid){
+
+				/*Unweave the node*/
+				*link = current->v_next;
+				freeVpte(current);
+			}
+			else{
+				link = &(current->v_next);
+			}
+		}
+	}
+}
@@ -3,11 +3,12 @@
 * 
 * This file sets up the intitial segment table and eight page tables for
 * each of the eight processes that will be running in the JAEOS 
-* operating system. It also starts the active delay daemon process and 
+* operating system. A process's kUseg2 page table only holds the pages
+* it has resident, every page it touches is described by the hashed
+* page table. It also starts the active delay daemon process and 
 * initializes the AVSL and the ADL.
 *
-* It also contains methods to copy one page of memory at a specified
-* location to another specified location, enable and disable interrupts,
+* It also contains methods to enable and disable interrupts,
 * the starting location for each user process.
 * 
 * Each process begins by reading its specified data (which is determined
@@ -28,6 +29,7 @@
 
 #include "../e/adl.e"
 #include "../e/avsl.e"
+#include "../e/hpt.e"
 
 #include "../e/initial.e"
 #include "../e/initProc.e"
@@ -97,8 +99,13 @@ void test(){
 				
 		swapPool[i].sw_asid = -1;
 		swapPool[i].sw_pte = NULL;
+		swapPool[i].sw_vpte = NULL;
 	}
 	
+	/*Initialize the hashed page table, nothing is pinned yet*/
+	initHPT();
+	pinnedFrames = 0;
+	
 	/*Initialize the swap semaphore to 1 for mutual exclusion*/
 	swapSem = 1;
 	
@@ -116,16 +123,27 @@ void test(){
 		uProcs[i-1].Tp_pte.header = (PTEMAGICNO << MAGICNOSHIFT) | 
 														   KUSEGPTESIZE;
 														   
+		/*Every slot starts out empty, pages are mapped as they are
+		 *brought into the swap pool*/
 		for(j = 0; j < KUSEGPTESIZE; j++){
 			
-			uProcs[i-1].Tp_pte.pteTable[j].pte_entryHI = 
-					 ((0x80000 + j) << ENTRYHISHIFT) | (i << ASIDSHIFT);
+			uProcs[i-1].Tp_pte.pteTable[j].pte_entryHI = EMPTYSLOT;
 			uProcs[i-1].Tp_pte.pteTable[j].pte_entryLO = ALLOFF | DIRTY;
 		}
+		uProcs[i-1].Tp_textPages = 0;
+		uProcs[i-1].Tp_bckStoreAddr = 0;
+		
+		/*The stack may grow down to its limit*/
+		uProcs[i-1].Tp_stackLimit = STACKTOPPAGE - (STACKMAXPAGES - 1);
 		
-		/*Initialize the last entry in the table*/
-		uProcs[i-1].Tp_pte.pteTable[KUSEGPTESIZE-1].pte_entryHI = 
-						  (0xBFFFF  << ENTRYHISHIFT) | (i << ASIDSHIFT);
+		/*No region is handed to a user-level pager yet*/
+		uProcs[i-1].Tp_pagerID = 0;
+		uProcs[i-1].Tp_pagerStart = 0;
+		uProcs[i-1].Tp_pagerEnd = 0;
+		uProcs[i-1].Tp_pagerSem = 0;
+		uProcs[i-1].Tp_faultPage = 0;
+		uProcs[i-1].Tp_faultState = PAGERIDLE;
+		uProcs[i-1].Tp_dead = FALSE;
 													
 		/*Find location of the segment table*/
 		segTable = (segTbl_t *) (SEGTBLSTART + (i * SEGTBLWIDTH));
@@ -157,6 +175,7 @@ void test(){
 	delayState.s_cpsr = ALLOFF | SYSTEMMODE;
 										
 	/*SYSCALL(CREATEPROCESS, (int)&delayState, 0, 0);*/
+	/*SYSCALL(SETPRIORITY, PRIODAEMON, TARGETCHILD, 0);*/
 		
 	/*Call passeren on the master semaphore for each process created*/
 	for (i = 0; i < MAXUSERPROC; i++){
@@ -260,7 +279,7 @@ void uProcInit(){
 		
 		enableInterrupts(FALSE);
 		/*Initialize where the data should be written and set command*/
-		tapeDevice->d_data0 = OSCODETOP + ((procID - 1) * PAGESIZE);
+		tapeDevice->d_data0 = TAPEBUFF(procID);
 		tapeDevice->d_command = READBLK;
 		
 		tapeStatus = SYSCALL(WAITFORIO, TAPEINT, (procID - 1), 0);
@@ -285,7 +304,7 @@ void uProcInit(){
 			
 			enableInterrupts(FALSE);
 			/*Initialize where to read from and set command to write*/
-			diskDevice->d_data0 = OSCODETOP + ((procID - 1) * PAGESIZE);
+			diskDevice->d_data0 = TAPEBUFF(procID);
 			diskDevice->d_command = ((procID - 1) << SECTORSHIFT) | 
 															   WRITEBLK;
 															   
@@ -307,6 +326,15 @@ void uProcInit(){
 	
 	/*Release mutex on tape device*/
 	SYSCALL(VERHOGEN, (int)&mutexSemArray[devNumber], 0, 0);
+	
+	/*The tape image fills the first blocks of backing store*/
+	uProcs[procID - 1].Tp_textPages = currentBlock;
+	uProcs[procID - 1].Tp_bckStoreAddr = currentBlock;
+	
+	/*The heap starts empty on the page after the tape image*/
+	uProcs[procID - 1].Tp_heapBase = KUSEG2ADDR + 
+											 (currentBlock * PAGESIZE);
+	uProcs[procID - 1].Tp_brk = uProcs[procID - 1].Tp_heapBase;
 		 
 	STST(&newStartState);
 	
@@ -380,22 +408,3 @@ void delayDaemon(){
 		}
 	}
 }
-
-/***********************************************************************
- *Function that copies one page of memory from a source memory address
- *to a destination memory address.
- *Returns: N/a
- **********************************************************************/
-void copyPage(int* source, int* target){
-	
-	int i = 0;
-	while(i < (PAGESIZE / WORDLEN)){
-		*target = *source;
-		
-		/*Move to the next word*/
-		source++;
-		target++;
-		i++;
-	}
-}
-
@@ -6,6 +6,7 @@
 
 #include "h/tconst.h"
 #include "print.e"
+#include "malloc.e"
 
 #define MILLION	1000000
 
@@ -14,8 +15,13 @@ void main() {
 	int i;
 	int dstatus;
 	int *buffer;
+	cpu_t start, before, busy;
 	
-	buffer = (int *)(SEG2 + (20 * PAGESIZE));
+	buffer = (int *)malloc(PAGESIZE);
+	if (buffer == NULL) {
+		print(WRITETERMINAL, "diskTest error: could not allocate buffer\n");
+		SYSCALL(TERMINATE, 0, 0, 0);
+	}
 
 	print(WRITETERMINAL, "diskTest starts\n");
 	*buffer = 42;  /*buffer[0] = 'a'; */
@@ -43,14 +49,22 @@ void main() {
 	else
 		print(WRITETERMINAL, "diskTest ok: second disk sector readback\n");
 
-	/* should eventually exceed device capacity */
+	/* should eventually exceed device capacity, the time spent in the
+	 * reads shows how busy the disk was kept */
 	i = 0;
+	busy = 0;
+	start = SYSCALL(GET_TOD, 0, 0, 0);
 	dstatus = SYSCALL(DISK_GET, (int)buffer, 1, i);
 	while ((dstatus == READY) && (i < MILLION)) {
 		i++;
+		before = SYSCALL(GET_TOD, 0, 0, 0);
 		dstatus = SYSCALL(DISK_GET, (int)buffer, 1, i);
+		busy = busy + (SYSCALL(GET_TOD, 0, 0, 0) - before);
 	}
 	
+	printNum(WRITETERMINAL, "diskTest: disk utilization (per mille) ",
+		busy / ((SYSCALL(GET_TOD, 0, 0, 0) - start) / 1000 + 1));
+	
 	if (i < MILLION)
 		print(WRITETERMINAL, "diskTest ok: device capacity detection\n");
 	else
@@ -15,6 +15,17 @@
 #define WRITEPRINTER	16
 #define GET_TOD			17
 #define TERMINATE		18
+#define SBRK			19
+#define MADVISE			20
+#define SETPAGER		21
+#define PAGERWAIT		22
+#define PAGERSUPPLY		23
+
+#define MADVNORMAL		0
+#define MADVWILLNEED	1
+#define MADVDONTNEED	2
+#define MADVSEQUENTIAL	3
+#define MADVPIN			4
 
 #define SEG0		0x00000000
 #define SEG1		0x40000000
@@ -0,0 +1,43 @@
+/* Tests that MADVISE DONTNEED zero fills heap pages and reloads pages
+ * loaded from tape. */
+#include "../../h/const.h"
+#include "../../h/types.h"
+
+#include "/usr/include/uarm/libuarm.h"
+
+#include "h/tconst.h"
+#include "print.e"
+
+
+void main () {
+	unsigned int heap;
+	unsigned int text;
+	int word;
+
+	print(WRITETERMINAL, "madviseTest starts\n");
+
+	/* grow the heap by two pages so one whole page lies inside it */
+	heap = (unsigned int) SYSCALL(SBRK, 2 * PAGESIZE, 0, 0);
+	heap = (heap + PAGESIZE - 1) & ~(PAGESIZE - 1);
+
+	/* dirty the heap page, then discard it */
+	*(int *) heap = 42;
+	SYSCALL(MADVISE, heap, PAGESIZE, MADVDONTNEED);
+
+	if (*(int *) heap == 0)
+		print(WRITETERMINAL, "madviseTest ok: heap page came back zeroed\n");
+	else
+		print(WRITETERMINAL, "madviseTest error: heap page kept its data\n");
+
+	/* discard the page holding this code, it must be read back as loaded */
+	text = ((unsigned int) main) & ~(PAGESIZE - 1);
+	word = *(int *) text;
+	SYSCALL(MADVISE, text, PAGESIZE, MADVDONTNEED);
+
+	if (*(int *) text == word)
+		print(WRITETERMINAL, "madviseTest ok: text page reloaded from disk\n");
+	else
+		print(WRITETERMINAL, "madviseTest error: text page was lost\n");
+
+	SYSCALL(TERMINATE, 0, 0, 0);
+}
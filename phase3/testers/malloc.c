@@ -0,0 +1,99 @@
+/* Small first-fit allocator for the testers, grows the heap with SBRK */
+
+#include "../../h/const.h"
+#include "../../h/types.h"
+
+#include "h/tconst.h"
+
+#include "/usr/include/uarm/libuarm.h"
+
+#define HEAPGROW	PAGESIZE	/* smallest amount to ask the kernel for */
+
+typedef struct header {
+	struct header *next;	/* next block on the free list */
+	unsigned int units;		/* size of this block in header units */
+} header;
+
+static header base;
+static header *freep = NULL;
+
+void free(void *ap) {
+	header *bp, *p;
+
+	if (ap == NULL)
+		return;
+
+	bp = (header *)ap - 1;
+
+	/* find the free blocks on either side of bp */
+	for (p = freep; !(bp > p && bp < p->next); p = p->next)
+		if (p >= p->next && (bp > p || bp < p->next))
+			break;
+
+	/* join to the upper neighbour */
+	if (bp + bp->units == p->next) {
+		bp->units += p->next->units;
+		bp->next = p->next->next;
+	} else
+		bp->next = p->next;
+
+	/* join to the lower neighbour */
+	if (p + p->units == bp) {
+		p->units += bp->units;
+		p->next = bp->next;
+	} else
+		p->next = bp;
+
+	freep = p;
+}
+
+static header *moreHeap(unsigned int units) {
+	header *up;
+	int bytes;
+
+	bytes = units * sizeof(header);
+	if (bytes < HEAPGROW)
+		bytes = HEAPGROW;
+
+	up = (header *)SYSCALL(SBRK, bytes, 0, 0);
+	if ((int)up == -1)
+		return NULL;
+
+	up->units = bytes / sizeof(header);
+	free((void *)(up + 1));
+	return freep;
+}
+
+void *malloc(unsigned int nbytes) {
+	header *p, *prevp;
+	unsigned int units;
+
+	units = (nbytes + sizeof(header) - 1) / sizeof(header) + 1;
+
+	/* first call, start with an empty circular free list */
+	if (freep == NULL) {
+		base.next = freep = &base;
+		base.units = 0;
+	}
+
+	prevp = freep;
+	for (p = prevp->next; ; prevp = p, p = p->next) {
+		if (p->units >= units) {
+			if (p->units == units)
+				prevp->next = p->next;
+			else {
+				/* hand out the tail end of the block */
+				p->units -= units;
+				p += p->units;
+				p->units = units;
+			}
+			freep = prevp;
+			return (void *)(p + 1);
+		}
+
+		/* wrapped around the free list, ask for more heap */
+		if (p == freep)
+			if ((p = moreHeap(units)) == NULL)
+				return NULL;
+	}
+}
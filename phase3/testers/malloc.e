@@ -0,0 +1,14 @@
+#ifndef MALLOCIT
+#define MALLOCIT
+
+/************************** MALLOC.E ******************************
+*
+*  Written by Jake Wagner
+*/
+
+extern void *malloc (unsigned int nbytes);
+extern void free (void *ap);
+
+/***************************************************************/
+
+#endif
@@ -21,3 +21,22 @@ void print(int device, char *str) {
 		SYSCALL (TERMINATE, 0, 0, 0);
 	}
 }
+
+/* prints a label followed by an unsigned number and a newline */
+void printNum(int device, char *label, unsigned int num) {
+
+	char buf[12];
+	int i = 10;
+	
+	buf[11] = '\0';
+	buf[10] = '\n';
+	
+	do {
+		i--;
+		buf[i] = '0' + (num % 10);
+		num = num / 10;
+	} while ((num > 0) && (i > 0));
+	
+	print(device, label);
+	print(device, &buf[i]);
+}
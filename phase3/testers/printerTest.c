@@ -7,9 +7,24 @@
 #include "h/tconst.h"
 #include "print.e"
 
+#define LINES	20
+
 void main() {
+	int i;
+	cpu_t start, before, busy = 0;
+	
 	print(WRITETERMINAL, "printTest is ok\n");
 	
+	/* the time spent in the writes shows how busy the terminal was kept */
+	start = SYSCALL(GET_TOD, 0, 0, 0);
+	for (i = 0; i < LINES; i++) {
+		before = SYSCALL(GET_TOD, 0, 0, 0);
+		print(WRITETERMINAL, "printTest: keeping the terminal busy\n");
+		busy = busy + (SYSCALL(GET_TOD, 0, 0, 0) - before);
+	}
+	printNum(WRITETERMINAL, "printTest: terminal utilization (per mille) ",
+		busy / ((SYSCALL(GET_TOD, 0, 0, 0) - start) / 1000 + 1));
+	
 	print(WRITEPRINTER, "printTest is ok\n");
 	
 	SYSCALL(TERMINATE, 0, 0, 0);
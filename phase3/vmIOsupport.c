@@ -14,14 +14,23 @@
 * current data in the frame if it was occupied to backing store, reading 
 * in the missing data from backing store and updating the respective 
 * page tables and swap pool data structure. Finally, the TLB is 
-* invalidated and execution resumes.
+* invalidated and execution resumes. Pages that have never been written
+* to backing store are zero filled instead of read. The stack sits at
+* the top of kUseg2 and grows down on demand until its limit, a fault
+* in the guard band below the limit kills the process. A process may
+* hand a region of kUseg2 to another U-proc acting as its pager, first
+* touches of that region are forwarded to the pager, which supplies the
+* page contents through the client's tape buffer in kSegOS, which is
+* free once the client's image is on backing store.
 * 
 * The available virtual memory Syscalls range from Syscall 9 (Read
-* Terminal) to Syscall 18 (Virtual Terminate Process). These Syscalls
+* Terminal) to Syscall 23 (Supply Page). These Syscalls
 * can read data from the terminal, write data to the terminal, perform
 * p and v operations on virtual semaphores, delay a process, read to 
 * disk and write from disk, write to a printer/file, get the current TOD
-* for a process, and terminate a process.
+* for a process, terminate a process, grow or shrink the heap, give
+* the pager hints about how a range of memory will be used and register
+* and serve a user-level pager.
 *
 * Written by Jake Wagner
 * Last Updated: 11-1-16
@@ -32,16 +41,19 @@
 
 #include "../e/adl.e"
 #include "../e/avsl.e"
+#include "../e/hpt.e"
 
 #include "../e/scheduler.e"
 #include "../e/initProc.e"
+#include "../e/memops.e"
 #include "../e/vmIOsupport.e"
 
 #include "/usr/include/uarm/libuarm.h"
 
 /***********************Global Definitions*****************************/
 
-/*No Global Definitions*/
+/*The number of swap pool frames held by pinned pages*/
+int pinnedFrames;
 
 /*************************Main Functions*******************************/
 
@@ -73,13 +85,10 @@ void vmMemHandler(){
 	debugF(0x99999999);
 
 	/*Local Variable Declarations*/
-	int missingSegNum, missingPageNum, frameNumber, currentPageNum, 
-														  currentProcID;
+	int missingSegNum, missingPageNum, frameNumber;
 	memaddr swapAddr;
-	devregarea_t* devReg = (devregarea_t *) DEVREGAREAADDR;
-	memaddr RAMTOP = devReg->ramtop;
-	memaddr SWAPPOOLSTART =  RAMTOP - (2 * PAGESIZE) - 
-												  (SWAPSIZE * PAGESIZE);
+	vpte_t *vpte = NULL;
+	int *fill = NULL;
 												  
 	int missingProcID = ((getEntryHi() & ENTRYMASK) >> ASIDSHIFT);
 	state_t* oldState = (state_t*) 
@@ -87,8 +96,21 @@ void vmMemHandler(){
 						  
 	int cause = oldState->s_CP15_Cause;
 	
-	/*If we can't find cause for TLB exception, nuke it!*/
-	if((cause != TLBL) && (cause != TLBS)){
+	/*Which segment and which page is missing?
+	Check the segment number & page number respectively*/
+	missingSegNum = (oldState->s_CP15_EntryHi >> SEGSHIFT);
+	missingPageNum = ((oldState->s_CP15_EntryHi & PAGENOMASK) >> 
+														  ENTRYHISHIFT);
+	
+	/*If the page is not in a user segment, nuke it!*/
+	if((missingSegNum != KUSEG2) && (missingSegNum != KUSEG3)){
+		virtualDeath(missingProcID);
+	}
+	
+	/*If the page is mapped and we can't find cause for TLB exception,
+	 *nuke it!*/
+	if((cause != TLBL) && (cause != TLBS) && 
+		  pageMapped(missingSegNum, missingPageNum, missingProcID)){
 		
 		debugA(6666, cause);
 		
@@ -96,74 +118,80 @@ void vmMemHandler(){
 		virtualDeath(missingProcID);
 	}
 	
-	/*Which segment and which page is missing?
-	Check the segment number & page number respectively*/
-	missingSegNum =(oldState->s_CP15_EntryHi >> 30);
-	missingPageNum = ((oldState->s_CP15_EntryHi & 0X3FFFF000) >> 12);
+	/*If the missing page number was higher than the shared table...*/
+	if((missingSegNum == KUSEG3) && (missingPageNum >= KUSEGPTESIZE)){
+		virtualDeath(missingProcID);
+	}
+	
+	/*If the stack has overflowed into its guard, nuke it before it
+	 *corrupts anything*/
+	if((missingSegNum == KUSEG2) && stackOverflow(missingProcID, 
+														missingPageNum)){
+		virtualDeath(missingProcID);
+	}
 	
-	/*If the missing page number was higher than the table size...*/
-	if(missingPageNum >= KUSEGPTESIZE){
-		missingPageNum = KUSEGPTESIZE - 1;
+	/*If a user-level pager owns the page, wait for it to supply it*/
+	if((missingSegNum == KUSEG2) && 
+					 pagerOwns(missingProcID, missingPageNum)){
+		fill = forwardFault(missingProcID, missingPageNum);
 	}
 	
 	/*Mutex on the swapPool data structure*/
 	SYSCALL(PASSEREN, (int)&swapSem, 0, 0);
 	
- 	/*Pick a frame to use and get it's address*/
- 	frameNumber = chooseFrame();
- 	swapAddr = SWAPPOOLSTART + (frameNumber * PAGESIZE);
-	
- 	/*If the frame is currently occupied...*/
- 	if(swapPool[frameNumber].sw_asid != -1){
-
-  		enableInterrupts(FALSE);
+	/*If the page is private, find its descriptor or make a new one*/
+	if(missingSegNum == KUSEG2){
 		
- 		/*Turn off the valid bit for the current occupant*/
- 		swapPool[frameNumber].sw_pte->pte_entryLO = 
-					swapPool[frameNumber].sw_pte->pte_entryLO & ~VALID;
- 		
- 		/*Clear the TLB*/
- 		TLBCLR();
- 		enableInterrupts(TRUE);
- 		
- 		currentProcID = swapPool[frameNumber].sw_asid;
- 		currentPageNum = swapPool[frameNumber].sw_pageNo;
- 		
- 		/*Write the page to backingstore*/
-		readWriteBacking(currentPageNum, currentProcID, 
-									  USERPROCHEAD, WRITEBLK, swapAddr);
-	 	
- 	}
-	
-	/*Read missing page into swap pool*/
-	readWriteBacking(missingPageNum, missingProcID, 
+		vpte = hptLookup(missingProcID, missingPageNum);
+		if(vpte == NULL){
+			vpte = newPage(missingProcID, missingPageNum);
+		}
+		
+		/*If the page could not be described, nuke it!*/
+		if(vpte == NULL){
+			SYSCALL(VERHOGEN, (int)&swapSem, 0, 0);
+			virtualDeath(missingProcID);
+		}
+		
+		/*Bring the page in*/
+		pageIn(vpte, missingProcID, fill);
+		
+		/*If the page is being read sequentially...*/
+		if(vpte->v_flags & VP_SEQUENTIAL){
+			readAhead(vpte, missingProcID);
+		}
+	}
+	else{
+		
+		/*Pick a frame to use and get it's address*/
+		frameNumber = chooseFrame();
+		swapAddr = frameAddress(frameNumber);
+		
+		/*Back up the current occupant of the frame*/
+		evictFrame(frameNumber, TRUE);
+		
+		/*Read missing page into swap pool*/
+		readWriteBacking(missingPageNum, missingProcID, 
 									   USERPROCHEAD, READBLK, swapAddr);
-	
-	enableInterrupts(FALSE);
-	
-	/*Update swap pool to reflect new page*/
- 	swapPool[frameNumber].sw_asid = missingProcID;
- 	swapPool[frameNumber].sw_segNo = missingSegNum;
- 	swapPool[frameNumber].sw_pageNo = missingPageNum;
- 	
- 	if(missingSegNum == KUSEG3){
+		
+		enableInterrupts(FALSE);
+		
+		/*Update swap pool to reflect new page*/
+		swapPool[frameNumber].sw_asid = missingProcID;
+		swapPool[frameNumber].sw_segNo = missingSegNum;
+		swapPool[frameNumber].sw_pageNo = missingPageNum;
+		swapPool[frameNumber].sw_vpte = NULL;
+		
 		/*Update kUSeg3 page table*/
 		swapPool[frameNumber].sw_pte = 
 									 &(kUSeg3.pteTable[missingPageNum]);
 		swapPool[frameNumber].sw_pte->pte_entryLO = swapAddr | VALID 
 													   | DIRTY | GLOBAL;
+		
+		/*Update TLB*/
+		TLBCLR();
+		enableInterrupts(TRUE);
 	}
-	else{
-		/*Update the missing page's page table entry*/
-		swapPool[frameNumber].sw_pte = 
-		   &(uProcs[missingProcID - 1].Tp_pte.pteTable[missingPageNum]);
-		swapPool[frameNumber].sw_pte->pte_entryLO = swapAddr | VALID 
-																| DIRTY;
-	}
-
-	/*Update TLB*/
-	TLBCLR();
-	enableInterrupts(TRUE);
 	
 	/*Release mutex from swapPool*/
 	SYSCALL(VERHOGEN,(int)&swapSem, 0, 0);
@@ -174,7 +202,7 @@ void vmMemHandler(){
 }
 /***********************************************************************
  *Function that handles all of the Virtual Memory Syscalls. It has a
- *switch statement that can handle Syscalls 9-18 for user mode 
+ *switch statement that can handle Syscalls 9-23 for user mode 
  *processes.
  *RETURNS: N/a
  **********************************************************************/
@@ -341,6 +369,68 @@ void vmSysHandler(){
 			virtualDeath(procID);
 			
 			break;
+		
+		/***************************************************************
+		*Syscall 19
+		*This syscall moves the end of the process's heap by the
+		*specified number of bytes and returns the old end of the heap.
+		*New heap pages are zero filled when they are first touched.
+		***************************************************************/
+		case SBRK:
+			
+			oldState->s_a1 = moveBreak(oldState->s_a2, procID);
+			
+			break;
+		
+		/***************************************************************
+		*Syscall 20
+		*This syscall applies a paging hint (WILLNEED, DONTNEED,
+		*SEQUENTIAL, PIN or NORMAL) to the specified range of kUseg2.
+		***************************************************************/
+		case MADVISE:
+			
+			oldState->s_a1 = adviseRange(oldState->s_a2, oldState->s_a3,
+										   oldState->s_a4, procID);
+			
+			break;
+		
+		/***************************************************************
+		*Syscall 21
+		*This syscall hands the specified range of kUseg2 to the
+		*specified U-proc, which becomes its pager. A length of zero
+		*takes the range back.
+		***************************************************************/
+		case SETPAGER:
+			
+			oldState->s_a1 = setPager(oldState->s_a2, oldState->s_a3,
+										   oldState->s_a4, procID);
+			
+			break;
+		
+		/***************************************************************
+		*Syscall 22
+		*This syscall blocks a pager until one of its clients faults
+		*and stores the client's ID and the faulting page's address in
+		*the specified two word request.
+		***************************************************************/
+		case PAGERWAIT:
+			
+			oldState->s_a1 = pagerWait((int *) oldState->s_a2, procID);
+			
+			break;
+		
+		/***************************************************************
+		*Syscall 23
+		*This syscall supplies the contents of the page the specified
+		*client is waiting on from the specified page sized buffer and
+		*wakes the client.
+		***************************************************************/
+		case PAGERSUPPLY:
+			
+			oldState->s_a1 = pagerSupply(oldState->s_a2, 
+									  (int *) oldState->s_a3, procID);
+			
+			break;
 	}
 	
 	/*Return to execution*/
@@ -351,16 +441,656 @@ void vmSysHandler(){
 /*************************Helper Functions*****************************/
 
 /***********************************************************************
- *Function that chooses the next frame to use in the swap pool in a
- *first-in-first-out fashion.
+ *Function that chooses the next frame to use in the swap pool. A free
+ *frame is used first, then a frame a sequential reader has already
+ *passed, and otherwise frames are taken in a first-in-first-out
+ *fashion. Pinned frames are never chosen.
  *RETURNS: Next frame victim
  **********************************************************************/
 int chooseFrame(){
 	
 	static int nextFrame = 0;
+	int i;
+	
+	/*If there is a free frame...*/
+	for(i = 0; i < SWAPSIZE; i++){
+		if(swapPool[i].sw_asid == -1){
+			return i;
+		}
+	}
+	
+	/*If there is a frame behind a sequential reader...*/
+	for(i = 0; i < SWAPSIZE; i++){
+		if((swapPool[i].sw_vpte != NULL) && 
+					((swapPool[i].sw_vpte->v_flags & 
+							(VP_BEHIND | VP_PIN)) == VP_BEHIND)){
+			return i;
+		}
+	}
+	
+	/*Take the next frame that is not pinned*/
+	for(i = 0; i < SWAPSIZE; i++){
+		nextFrame = (nextFrame + 1) % SWAPSIZE;
+		
+		if((swapPool[nextFrame].sw_vpte == NULL) || 
+				!(swapPool[nextFrame].sw_vpte->v_flags & VP_PIN)){
+			return(nextFrame);
+		}
+	}
+	
+	/*Every frame is pinned*/
+	PANIC();
+	return FAILURE;
+}
+
+/***********************************************************************
+ *Function that computes the physical address of a swap pool frame.
+ *RETURNS: the address of the frame
+ **********************************************************************/
+memaddr frameAddress(int frameNumber){
+	
+	devregarea_t* devReg = (devregarea_t *) DEVREGAREAADDR;
+	memaddr SWAPPOOLSTART = devReg->ramtop - (2 * PAGESIZE) - 
+												  (SWAPSIZE * PAGESIZE);
+	
+	return (SWAPPOOLSTART + (frameNumber * PAGESIZE));
+}
+
+/***********************************************************************
+ *Function that empties a frame of the swap pool. The occupant's page
+ *table entry is invalidated and, if asked to, the page is written to
+ *its backing store block. The swap pool mutex must be held.
+ *RETURNS: N/a
+ **********************************************************************/
+void evictFrame(int frameNumber, int writeBack){
+	
+	int ownerID = swapPool[frameNumber].sw_asid;
+	int block = swapPool[frameNumber].sw_pageNo;
+	vpte_t *vpte = swapPool[frameNumber].sw_vpte;
+	
+	/*If the frame is free...*/
+	if(ownerID == -1){
+		return;
+	}
+	
+	enableInterrupts(FALSE);
+	
+	/*Turn off the valid bit for the current occupant*/
+	swapPool[frameNumber].sw_pte->pte_entryLO = 
+					swapPool[frameNumber].sw_pte->pte_entryLO & ~VALID;
+	
+	/*If the occupant was a private page, free its slot*/
+	if(vpte != NULL){
+		swapPool[frameNumber].sw_pte->pte_entryHI = EMPTYSLOT;
+		vpte->v_frame = -1;
+		vpte->v_flags = vpte->v_flags & ~VP_BEHIND;
+		block = vpte->v_block;
+		
+		if(writeBack){
+			vpte->v_flags = vpte->v_flags | VP_ONDISK;
+		}
+	}
+	
+	swapPool[frameNumber].sw_asid = -1;
+	swapPool[frameNumber].sw_vpte = NULL;
+	
+	/*Clear the TLB*/
+	TLBCLR();
+	enableInterrupts(TRUE);
+	
+	/*Write the page to backingstore*/
+	if(writeBack){
+		readWriteBacking(block, ownerID, USERPROCHEAD, WRITEBLK, 
+										  frameAddress(frameNumber));
+	}
+}
+
+/***********************************************************************
+ *Function that brings a page of kUseg2 into the swap pool and maps it
+ *in a free slot of its process's page table. Pages that have never
+ *been written to backing store are copied from the given fill page, or
+ *zero filled if there is none, through their new mapping instead of
+ *read, so this must run on behalf of the page's own process. The swap
+ *pool mutex must be held.
+ *RETURNS: N/a
+ **********************************************************************/
+void pageIn(vpte_t *vpte, int procID, int *fill){
+	
+	pteEntry_t *slot;
+	memaddr swapAddr;
+	int frameNumber;
+	
+	/*If the page is already resident...*/
+	if(vpte->v_frame != -1){
+		return;
+	}
+	
+	/*Pick a frame to use and empty it*/
+	frameNumber = chooseFrame();
+	swapAddr = frameAddress(frameNumber);
+	evictFrame(frameNumber, TRUE);
+	
+	/*Read the page into swap pool*/
+	if(vpte->v_flags & VP_ONDISK){
+		readWriteBacking(vpte->v_block, procID, USERPROCHEAD, READBLK, 
+															  swapAddr);
+	}
+	
+	/*Map the page in a free slot of its page table*/
+	slot = findSlot(&(uProcs[procID - 1].Tp_pte), EMPTYSLOT);
+	if(slot == NULL){
+		PANIC();
+	}
+	
+	enableInterrupts(FALSE);
+	
+	/*Update swap pool to reflect new page*/
+ 	swapPool[frameNumber].sw_asid = procID;
+ 	swapPool[frameNumber].sw_segNo = KUSEG2;
+ 	swapPool[frameNumber].sw_pageNo = vpte->v_pageNo;
+	swapPool[frameNumber].sw_vpte = vpte;
+	swapPool[frameNumber].sw_pte = slot;
+	
+	slot->pte_entryHI = (KUSEG2ADDR | (vpte->v_pageNo << ENTRYHISHIFT)) 
+											  | (procID << ASIDSHIFT);
+	slot->pte_entryLO = swapAddr | VALID | DIRTY;
+	vpte->v_frame = frameNumber;
+	
+	/*Update TLB*/
+	TLBCLR();
+	enableInterrupts(TRUE);
+	
+	/*If the page is brand new, fill it or zero it*/
+	if(!(vpte->v_flags & VP_ONDISK)){
+		if(fill != NULL){
+			copyPage(fill, 
+				 (int *) (KUSEG2ADDR | (vpte->v_pageNo << ENTRYHISHIFT)));
+		}
+		else{
+			zeroPage((int *) 
+					(KUSEG2ADDR | (vpte->v_pageNo << ENTRYHISHIFT)));
+		}
+	}
+}
+
+/***********************************************************************
+ *Function that reads ahead of a sequential reader of kUseg2. The pages
+ *after the given page that are on backing store are brought in and the
+ *page before it is marked so it is evicted first. The given page is
+ *pinned while the others are read so none of them can take its frame,
+ *and read-ahead never needs more frames than are left unpinned. The
+ *swap pool mutex must be held.
+ *RETURNS: N/a
+ **********************************************************************/
+void readAhead(vpte_t *vpte, int procID){
+	
+	int i;
+	vpte_t *next;
+	vpte_t *behind = hptLookup(procID, vpte->v_pageNo - 1);
+	int budget = SWAPSIZE - pinnedFrames - 1;
+	int pinned = (vpte->v_flags & VP_PIN);
+	
+	/*Drop the page behind the cursor early*/
+	if((behind != NULL) && (behind->v_flags & VP_SEQUENTIAL) && 
+											  (behind->v_frame != -1)){
+		behind->v_flags = behind->v_flags | VP_BEHIND;
+	}
+	
+	/*Keep the page just brought in where it is*/
+	vpte->v_flags = vpte->v_flags | VP_PIN;
+	
+	for(i = 1; (i <= READAHEAD) && (i <= budget); i++){
+		
+		next = hptLookup(procID, vpte->v_pageNo + i);
+		
+		/*If the next page is sequential and only on backing store...*/
+		if((next != NULL) && (next->v_flags & VP_SEQUENTIAL) && 
+				  (next->v_flags & VP_ONDISK) && (next->v_frame == -1)){
+			pageIn(next, procID, NULL);
+		}
+	}
+	
+	if(!pinned){
+		vpte->v_flags = vpte->v_flags & ~VP_PIN;
+	}
+}
+
+/***********************************************************************
+ *Function that applies a paging hint to a range of the specified
+ *process's kUseg2 pages. WILLNEED brings the pages in now, DONTNEED
+ *drops them without writing them back so heap and stack pages read
+ *back as zeros and pages loaded from tape read back as loaded,
+ *SEQUENTIAL turns on read-ahead and early eviction behind the reader,
+ *PIN keeps the pages resident and NORMAL clears SEQUENTIAL and PIN.
+ *Pages a user-level pager has yet to supply are not brought in.
+ *RETURNS: SUCCESS or FAILURE if the hint could not be applied to the
+ *whole range
+ **********************************************************************/
+int adviseRange(memaddr addr, int len, int advice, int procID){
+	
+	vpte_t *vpte;
+	int pageNo, firstPage, lastPage;
+	int prefetched = 0;
+	int status = SUCCESS;
 	
-	nextFrame = (nextFrame + 1) % SWAPSIZE;
-	return(nextFrame);
+	firstPage = ((addr & PAGENOMASK) >> ENTRYHISHIFT);
+	lastPage = (((addr + len - 1) & PAGENOMASK) >> ENTRYHISHIFT);
+	
+	/*If the range is empty or leaves kUseg2...*/
+	if((len <= 0) || ((addr >> SEGSHIFT) != KUSEG2) || 
+						(((addr + len - 1) >> SEGSHIFT) != KUSEG2)){
+		return FAILURE;
+	}
+	
+	/*Mutex on the swapPool data structure*/
+	SYSCALL(PASSEREN, (int)&swapSem, 0, 0);
+	
+	for(pageNo = firstPage; (pageNo <= lastPage) && 
+								   (status == SUCCESS); pageNo++){
+		
+		/*The stack guard may never be mapped*/
+		if(stackOverflow(procID, pageNo)){
+			status = FAILURE;
+			break;
+		}
+		
+		vpte = hptLookup(procID, pageNo);
+		
+		/*Hints that need the page make a descriptor for it*/
+		if((vpte == NULL) && (advice == MADVWILLNEED || 
+				advice == MADVSEQUENTIAL || advice == MADVPIN)){
+			vpte = newPage(procID, pageNo);
+			
+			if(vpte == NULL){
+				status = FAILURE;
+				break;
+			}
+		}
+		
+		/*If the page has never been touched there is nothing to do*/
+		if(vpte == NULL){
+			continue;
+		}
+		
+		switch(advice){
+			
+			case MADVNORMAL:
+				if(vpte->v_flags & VP_PIN){
+					pinnedFrames--;
+				}
+				vpte->v_flags = vpte->v_flags & 
+							  ~(VP_SEQUENTIAL | VP_BEHIND | VP_PIN);
+				break;
+			
+			case MADVWILLNEED:
+				/*Prefetching more than the pool holds just thrashes*/
+				if((vpte->v_frame == -1) && 
+						(prefetched < (SWAPSIZE - pinnedFrames)) &&
+						!pagerOwns(procID, pageNo)){
+					pageIn(vpte, procID, NULL);
+					prefetched++;
+				}
+				break;
+			
+			case MADVDONTNEED:
+				if(vpte->v_flags & VP_PIN){
+					pinnedFrames--;
+				}
+				vpte->v_flags = vpte->v_flags & ~(VP_PIN | VP_BEHIND);
+				
+				/*Drop the frame without writing it back*/
+				if(vpte->v_frame != -1){
+					evictFrame(vpte->v_frame, FALSE);
+				}
+				
+				/*A page loaded from tape reads back from its block,
+				 *which is the only copy of the program image*/
+				if(pageNo >= uProcs[procID - 1].Tp_textPages){
+					vpte->v_flags = vpte->v_flags & ~VP_ONDISK;
+				}
+				break;
+			
+			case MADVSEQUENTIAL:
+				vpte->v_flags = vpte->v_flags | VP_SEQUENTIAL;
+				break;
+			
+			case MADVPIN:
+				if(!(vpte->v_flags & VP_PIN)){
+					
+					/*Always leave one frame to page through*/
+					if((pinnedFrames >= (SWAPSIZE - 1)) || 
+							   pagerOwns(procID, pageNo)){
+						status = FAILURE;
+						break;
+					}
+					pageIn(vpte, procID, NULL);
+					vpte->v_flags = vpte->v_flags | VP_PIN;
+					pinnedFrames++;
+				}
+				break;
+			
+			default:
+				status = FAILURE;
+				break;
+		}
+	}
+	
+	/*Release mutex from swapPool*/
+	SYSCALL(VERHOGEN, (int)&swapSem, 0, 0);
+	
+	return status;
+}
+
+/***********************************************************************
+ *Function that finds the slot in the given page table whose entryHI
+ *matches the given entryHI. Searching for EMPTYSLOT finds a slot that
+ *is not mapping any page.
+ *RETURNS: a pointer to the slot or NULL if there is no such slot
+ **********************************************************************/
+pteEntry_t *findSlot(pte_t *pageTable, unsigned int entryHI){
+	
+	int i;
+	
+	for(i = 0; i < KUSEGPTESIZE; i++){
+		if(pageTable->pteTable[i].pte_entryHI == entryHI){
+			return &(pageTable->pteTable[i]);
+		}
+	}
+	return NULL;
+}
+
+/***********************************************************************
+ *Function that checks whether the given page of the given segment is
+ *currently mapped for the specified process.
+ *RETURNS: TRUE if the page has a valid entry, FALSE otherwise
+ **********************************************************************/
+int pageMapped(int segNo, int pageNo, int procID){
+	
+	pteEntry_t *slot;
+	
+	/*If the page is in the shared segment...*/
+	if(segNo == KUSEG3){
+		return ((pageNo < KUSEGPTESIZE) && 
+					(kUSeg3.pteTable[pageNo].pte_entryLO & VALID));
+	}
+	
+	slot = findSlot(&(uProcs[procID - 1].Tp_pte), (KUSEG2ADDR | 
+						 (pageNo << ENTRYHISHIFT)) | (procID << ASIDSHIFT));
+	
+	return ((slot != NULL) && (slot->pte_entryLO & VALID));
+}
+
+/***********************************************************************
+ *Function that hands out the next unused backing store block of the
+ *specified process. Blocks are the cylinders of the process's sector
+ *on the backingstore disk, so the disk geometry bounds them.
+ *RETURNS: the block number or FAILURE if the process has used them all
+ **********************************************************************/
+int allocBlock(int procID){
+	
+	devregarea_t* devReg = (devregarea_t *) DEVREGAREAADDR;
+	device_t* diskDevice = (device_t *) (devReg->devregbase);
+	int maxCylinder = (diskDevice->d_data1 >> CYLSHIFT);
+	
+	/*If the process has run out of backing store...*/
+	if(uProcs[procID - 1].Tp_bckStoreAddr >= maxCylinder){
+		return FAILURE;
+	}
+	
+	uProcs[procID - 1].Tp_bckStoreAddr++;
+	return (uProcs[procID - 1].Tp_bckStoreAddr - 1);
+}
+
+/***********************************************************************
+ *Function that checks whether a fault on the given page of kUseg2 is
+ *the specified process's stack running past its limit. Pages in the
+ *guard band just below the limit can only be reached by an overflowing
+ *stack.
+ *RETURNS: TRUE if the stack overflowed, FALSE otherwise
+ **********************************************************************/
+int stackOverflow(int procID, int pageNo){
+	
+	int limit = uProcs[procID - 1].Tp_stackLimit;
+	
+	return ((pageNo < limit) && (pageNo >= (limit - STACKGUARDPAGES)));
+}
+
+/***********************************************************************
+ *Function that describes a page of kUseg2 the first time the specified
+ *process touches it. Pages read in from tape already live in the
+ *matching backing store block, every other page gets a fresh block.
+ *RETURNS: a pointer to the new page descriptor or NULL if the page
+ *could not be described
+ **********************************************************************/
+vpte_t *newPage(int procID, int pageNo){
+	
+	vpte_t *vpte;
+	int block = pageNo;
+	
+	/*If the page was not loaded from tape...*/
+	if(pageNo >= uProcs[procID - 1].Tp_textPages){
+		block = allocBlock(procID);
+		
+		if(block == FAILURE){
+			return NULL;
+		}
+	}
+	
+	vpte = hptInsert(procID, pageNo);
+	if(vpte != NULL){
+		vpte->v_block = block;
+		
+		/*Only pages from tape have anything on backing store yet*/
+		if(pageNo < uProcs[procID - 1].Tp_textPages){
+			vpte->v_flags = VP_ONDISK;
+		}
+	}
+	
+	return vpte;
+}
+
+/***********************************************************************
+ *Function that moves the end of the specified process's heap by the
+ *given number of bytes. The heap may not shrink below its base or grow
+ *into the guard band below the stack limit.
+ *RETURNS: the old end of the heap or FAILURE if it could not be moved
+ **********************************************************************/
+int moveBreak(int increment, int procID){
+	
+	memaddr oldBreak = uProcs[procID - 1].Tp_brk;
+	memaddr newBreak = oldBreak + increment;
+	memaddr heapTop = KUSEG2ADDR + ((uProcs[procID - 1].Tp_stackLimit - 
+								   STACKGUARDPAGES) << ENTRYHISHIFT);
+	
+	/*If the break would leave the heap region...*/
+	if((increment < 0 && newBreak < uProcs[procID - 1].Tp_heapBase) ||
+			(increment > 0 && (newBreak > heapTop || newBreak < oldBreak))){
+		return FAILURE;
+	}
+	
+	uProcs[procID - 1].Tp_brk = newBreak;
+	return oldBreak;
+}
+
+/***********************************************************************
+ *Function that hands the given range of kUseg2 of the specified process
+ *to the U-proc with the given ID, which becomes the range's pager. The
+ *pager must be another U-proc that has not died. A length of zero takes
+ *the range back from its pager.
+ *RETURNS: SUCCESS or FAILURE if the range or the pager is not valid
+ **********************************************************************/
+int setPager(memaddr addr, int len, int pagerID, int procID){
+	
+	/*If the range is being taken back...*/
+	if(len == 0){
+		uProcs[procID - 1].Tp_pagerID = 0;
+		return SUCCESS;
+	}
+	
+	/*If the range leaves kUseg2 or the pager is not another live
+	 *U-proc...*/
+	if((len < 0) || ((addr >> SEGSHIFT) != KUSEG2) || 
+			(((addr + len - 1) >> SEGSHIFT) != KUSEG2) || 
+			(pagerID < 1) || (pagerID > MAXUSERPROC) || 
+			(pagerID == procID) || uProcs[pagerID - 1].Tp_dead){
+		return FAILURE;
+	}
+	
+	uProcs[procID - 1].Tp_pagerStart = ((addr & PAGENOMASK) >> ENTRYHISHIFT);
+	uProcs[procID - 1].Tp_pagerEnd = 
+					  (((addr + len - 1) & PAGENOMASK) >> ENTRYHISHIFT);
+	uProcs[procID - 1].Tp_pagerID = pagerID;
+	
+	return SUCCESS;
+}
+
+/***********************************************************************
+ *Function that checks whether a fault on the given page of kUseg2 must
+ *be forwarded to the specified process's user-level pager. Only pages
+ *that have nothing on backing store yet are forwarded, once supplied a
+ *page pages in and out like any other.
+ *RETURNS: TRUE if the pager must supply the page, FALSE otherwise
+ **********************************************************************/
+int pagerOwns(int procID, int pageNo){
+	
+	vpte_t *vpte;
+	
+	/*If the page is outside the pager's range...*/
+	if((uProcs[procID - 1].Tp_pagerID == 0) || 
+			(pageNo < uProcs[procID - 1].Tp_pagerStart) || 
+			(pageNo > uProcs[procID - 1].Tp_pagerEnd)){
+		return FALSE;
+	}
+	
+	vpte = hptLookup(procID, pageNo);
+	
+	return ((vpte == NULL) || !(vpte->v_flags & VP_ONDISK));
+}
+
+/***********************************************************************
+ *Function that forwards a fault of the specified process to its
+ *user-level pager and blocks the process until the pager supplies the
+ *page. The swap pool mutex must not be held. If the pager dies first
+ *the process is killed.
+ *RETURNS: the bounce page holding the supplied contents
+ **********************************************************************/
+int *forwardFault(int procID, int pageNo){
+	
+	Tproc_t *client = &(uProcs[procID - 1]);
+	
+	/*If the pager died since the fault was checked, nuke it!*/
+	if(client->Tp_pagerID == 0){
+		virtualDeath(procID);
+	}
+	
+	/*Post the request and wake the pager*/
+	client->Tp_faultPage = pageNo;
+	client->Tp_faultState = PAGERPENDING;
+	SYSCALL(VERHOGEN, 
+			  (int) &(uProcs[client->Tp_pagerID - 1].Tp_pagerSem), 0, 0);
+	
+	/*Wait for the page*/
+	SYSCALL(PASSEREN, (int) &(client->Tp_sem), 0, 0);
+	
+	/*If the pager died before supplying it, nuke it!*/
+	if(client->Tp_faultState == PAGERFAILED){
+		client->Tp_faultState = PAGERIDLE;
+		virtualDeath(procID);
+	}
+	
+	client->Tp_faultState = PAGERIDLE;
+	return (int *) PAGERBUFF(procID);
+}
+
+/***********************************************************************
+ *Function that blocks the specified pager until one of its clients
+ *faults. The client's ID and the address of the faulting page are
+ *stored in the given two word request.
+ *RETURNS: SUCCESS or FAILURE if no request was found
+ **********************************************************************/
+int pagerWait(int *request, int procID){
+	
+	int i;
+	
+	/*If the request lives in kSegOS, nuke it!*/
+	if((memaddr) request < KUSEG2ADDR){
+		virtualDeath(procID);
+	}
+	
+	/*Wait for a client to fault*/
+	SYSCALL(PASSEREN, (int) &(uProcs[procID - 1].Tp_pagerSem), 0, 0);
+	
+	/*Claim the pending request*/
+	for(i = 0; i < MAXUSERPROC; i++){
+		if((uProcs[i].Tp_pagerID == procID) && 
+						 (uProcs[i].Tp_faultState == PAGERPENDING)){
+			
+			uProcs[i].Tp_faultState = PAGERCLAIMED;
+			request[0] = i + 1;
+			request[1] = KUSEG2ADDR | 
+							   (uProcs[i].Tp_faultPage << ENTRYHISHIFT);
+			return SUCCESS;
+		}
+	}
+	return FAILURE;
+}
+
+/***********************************************************************
+ *Function that supplies the page the given client is waiting on from
+ *the specified pager's buffer. The buffer is copied into the client's
+ *bounce page and the client maps it itself once it wakes.
+ *RETURNS: SUCCESS or FAILURE if the client is not waiting on the pager
+ **********************************************************************/
+int pagerSupply(int requestID, int *buffer, int procID){
+	
+	Tproc_t *client;
+	
+	/*If the buffer lives in kSegOS, nuke it!*/
+	if((memaddr) buffer < KUSEG2ADDR){
+		virtualDeath(procID);
+	}
+	
+	/*If the client did not ask this pager for a page...*/
+	if((requestID < 1) || (requestID > MAXUSERPROC)){
+		return FAILURE;
+	}
+	client = &(uProcs[requestID - 1]);
+	if((client->Tp_pagerID != procID) || 
+						  (client->Tp_faultState != PAGERCLAIMED)){
+		return FAILURE;
+	}
+	
+	copyPage(buffer, (int *) PAGERBUFF(requestID));
+	
+	/*Wake the client*/
+	client->Tp_faultState = PAGERSUPPLIED;
+	SYSCALL(VERHOGEN, (int) &(client->Tp_sem), 0, 0);
+	
+	return SUCCESS;
+}
+
+/***********************************************************************
+ *Function that takes every range away from the specified dying pager
+ *and wakes any client still waiting on it so the client is killed.
+ *RETURNS: N/a
+ **********************************************************************/
+void pagerDeath(int procID){
+	
+	int i;
+	
+	for(i = 0; i < MAXUSERPROC; i++){
+		if(uProcs[i].Tp_pagerID == procID){
+			
+			uProcs[i].Tp_pagerID = 0;
+			
+			/*If the client is waiting on a page...*/
+			if((uProcs[i].Tp_faultState == PAGERPENDING) || 
+					   (uProcs[i].Tp_faultState == PAGERCLAIMED)){
+				uProcs[i].Tp_faultState = PAGERFAILED;
+				SYSCALL(VERHOGEN, (int) &(uProcs[i].Tp_sem), 0, 0);
+			}
+		}
+	}
 }
 
 /***********************************************************************
@@ -416,9 +1146,9 @@ void readWriteBacking(int cylinder, int sector, int head,
 /***********************************************************************
  *Function that handles virtual killing of the specified process. It
  *does all of the cleaning to make sure that the swapPool structure, TLB
- *and the specified process' page table are all invalidated. It then
- *calls to V the master semaphore and terminate the process and it's
- *child processes.
+ *and the specified process' page table are all invalidated and that no
+ *client is left waiting on it as its pager. It then calls to V the
+ *master semaphore and terminate the process and it's child processes.
  *RETURNS: N/a
  **********************************************************************/
 void virtualDeath(int procID){
@@ -427,6 +1157,11 @@ void virtualDeath(int procID){
 	int i;
 	int modified = FALSE;
 	
+	/*No client may take the process as its pager from now on, and any
+	 *client still waiting on it is failed*/
+	uProcs[procID - 1].Tp_dead = TRUE;
+	pagerDeath(procID);
+	
 	/*Mutex on the swapPool data structure*/
 	SYSCALL(PASSEREN, (int)&swapSem,0,0);
 	
@@ -435,8 +1170,18 @@ void virtualDeath(int procID){
 	for(i = 0; i < SWAPSIZE; i++){
 		if(swapPool[i].sw_asid == procID){
 			swapPool[i].sw_pte->pte_entryLO = 
-							(swapPool[i].sw_pte->pte_entryLO | ~VALID);
+							(swapPool[i].sw_pte->pte_entryLO & ~VALID);
+			
+			/*If it was a private page, free its slot and its pin*/
+			if(swapPool[i].sw_vpte != NULL){
+				swapPool[i].sw_pte->pte_entryHI = EMPTYSLOT;
+				
+				if(swapPool[i].sw_vpte->v_flags & VP_PIN){
+					pinnedFrames--;
+				}
+			}
 			swapPool[i].sw_asid = -1;
+			swapPool[i].sw_vpte = NULL;
 			modified = TRUE;
 		}
 	}
@@ -445,6 +1190,9 @@ void virtualDeath(int procID){
 	}
 	enableInterrupts(TRUE);
 	
+	/*Forget every page the process touched*/
+	hptRemoveProc(procID);
+	
 	/*Release mutex on swapPool*/
 	SYSCALL(VERHOGEN,(int)&swapSem, 0, 0);
 	
@@ -614,7 +1362,7 @@ void diskIO(int* blockAddr, int diskNo, int sectNo,
 	int sector;
 	int cylinder;
 	unsigned int diskStatus;
-	int* diskBuffer = (int *)(OSCODETOP + (diskNo * PAGESIZE));
+	int* diskBuffer = (int *) DISKBUFF(diskNo);
 	state_t* oldState = 
 					   (state_t *) &uProcs[procID-1].Told_trap[SYSTRAP];
 	devregarea_t* devReg = (devregarea_t *) DEVREGAREAADDR;